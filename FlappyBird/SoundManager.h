@@ -1,69 +1,164 @@
 #ifndef SOUNDMANAGER_H
 #define SOUNDMANAGER_H
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <vector>
 #include <iostream>
 #include "freealut\alut.h"
 #include "OpenAL\al.h"
 #include "OpenAL\alc.h"
+#include "wavFile.h"
+#include "audioMixer.h"
+#include "audioBackend.h"
+#include "musicPlayer.h"
+
+// ѻʽͽһOpenALԴ: СŶ, ӳԼPERIOD * BUFFERS֡
+class OpenAlBackend : public AudioBackend {
+public:
+	static constexpr int BUFFERS = 3;
+	static constexpr std::size_t PERIOD = 512;
+
+	// Needs the OpenAL context (alutInit)
+	OpenAlBackend() {
+		alGenSources(1, &source);
+		alGenBuffers(BUFFERS, buffers);
+		alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+	}
+
+	OpenAlBackend(const OpenAlBackend&) = delete;
+	OpenAlBackend(OpenAlBackend&&) = delete;
+	OpenAlBackend &operator=(const OpenAlBackend&) = delete;
+	OpenAlBackend &operator=(OpenAlBackend&&) = delete;
+
+	~OpenAlBackend() override {
+		this->stop();
+		alDeleteSources(1, &source);
+		alDeleteBuffers(BUFFERS, buffers);
+	}
+
+	void start(AudioMixer &mixer) override {
+		this->stop();
+		this->running = true;
+		this->thread = std::thread([this, &mixer] {
+			std::vector<std::int16_t> period(PERIOD * AudioMixer::CHANNELS);
+			for (ALuint buffer : buffers)
+				this->fill(mixer, buffer, period);
+			alSourceQueueBuffers(source, BUFFERS, buffers);
+			alSourcePlay(source);
+
+			while (this->running) {
+				ALint processed = 0;
+				alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+				for (; processed > 0; --processed) {
+					ALuint buffer;
+					alSourceUnqueueBuffers(source, 1, &buffer);
+					this->fill(mixer, buffer, period);
+					alSourceQueueBuffers(source, 1, &buffer);
+				}
+				// Every buffer ran dry (the thread was starved): restart the stream
+				ALint state;
+				alGetSourcei(source, AL_SOURCE_STATE, &state);
+				if (state != AL_PLAYING)
+					alSourcePlay(source);
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+			alSourceStop(source);
+			alSourcei(source, AL_BUFFER, 0);
+		});
+	}
+
+	void stop() override {
+		this->running = false;
+		if (this->thread.joinable())
+			this->thread.join();
+	}
+
+private:
+	void fill(AudioMixer &mixer, ALuint buffer, std::vector<std::int16_t> &period) {
+		mixer.render(period.data(), PERIOD);
+		alBufferData(buffer, AL_FORMAT_STEREO16, period.data(), static_cast<ALsizei>(period.size() * sizeof(std::int16_t)), mixer.sampleRate());
+	}
+
+	ALuint source;
+	ALuint buffers[BUFFERS];
+	std::atomic<bool> running{ false };
+	std::thread thread;
+};
+
 
 // Ƶ
+// Sounds are mixed in software (AudioMixer), so one sound can overlap itself
+// and play() only queues a command for the audio thread
 class SoundManager {
 public:
 	class SoundException {};
 
-	static bool setUp(int argc, char *argv[]) {
-		if (isSetUp)
-			return false;
-		command.first = argc;
-		command.second = argv;
-		isSetUp = true;
-		return true;
-	}
+	// alutInit is process-wide: create one SoundManager per process and
+	// share it between all game worlds.
+	// Without an audio device the game keeps running silently on a NullBackend.
+	SoundManager(int argc, char *argv[]) {
+		if (!alutInit(&argc, argv)) {
+			fprintf(stderr, "ALUT error: %s, continuing without sound\n",
+				alutGetErrorString(alutGetError()));
+			mixer.attach(music);
+			backend = std::make_unique<NullBackend>();
+			backend->start(mixer);
+			return;
+		}
+		alut = true;
+
+		ALfloat listenerPos[] = { 0.0, 0.0, 0.0 };
+		ALfloat listenerVel[] = { 0.0, 0.0, 0.0 };
+		ALfloat listenerOri[] = { 0.0, 0.0, -1.0,  0.0, 1.0, 0.0 }; // (first 3 elements are "at", second 3 are "up")  
+		alListenerfv(AL_POSITION, listenerPos);
+		alListenerfv(AL_VELOCITY, listenerVel);
+		alListenerfv(AL_ORIENTATION, listenerOri);
 
-	// Singleton
-	// ģʽ
-	static std::shared_ptr<SoundManager> instance() {
-		if (isSetUp) {
-			if (!pManager)
-				pManager = std::shared_ptr<SoundManager>(new SoundManager(command.first, command.second));
+		mixer.attach(music);
+		backend = std::make_unique<OpenAlBackend>();
+		backend->start(mixer);
+	}
 
-			return pManager;
-		}
+	// Any backend, e.g. OfflineBackend for tests; touches no OpenAL state
+	explicit SoundManager(std::unique_ptr<AudioBackend> output) : backend(std::move(output)) {
+		mixer.attach(music);
+		backend->start(mixer);
+	}
 
-		else {
+	// retrun index of the file
+	// Ƶ
+	std::size_t load(const char *fileName, const SoundParams &params = SoundParams()) {
+		std::vector<std::uint8_t> bytes;
+		PcmData pcm;
+		if (readFile(fileName, bytes) && !decodeWav(bytes.data(), bytes.size(), pcm)) {
 			std::cerr << "ERROR: in " << __FILE__
 				<< " line " << __LINE__
-				<< ": SoundManager is not set up yet." << std::endl;
-			throw SoundException();
+				<< ": unsupported wav " << fileName << std::endl;
 		}
+		return this->load(pcm, params);
 	}
 
-	// retrun index of the file
-	// Ƶ
-	std::size_t load(const char *fileName) {
-		ALuint buffer = alutCreateBufferFromFile(fileName);
-
-		ALuint source;
-		alGenSources(1, &source);
-		ALfloat sourcePos[] = { 0.0, 0.0, 0.0 }; // Դλ 	
-		ALfloat sourceVel[] = { 0.0, 0.0, 0.0 }; // Դٶ  
-		alSourcei(source, AL_BUFFER, buffer);
-		alSourcef(source, AL_PITCH, 1.0f);
-		alSourcef(source, AL_GAIN, 1.0f);
-		alSourcefv(source, AL_POSITION, sourcePos);
-		alSourcefv(source, AL_VELOCITY, sourceVel);
-
-		sounds.push_back({ source, buffer });
-		return sounds.size() - 1;
+	// Samples decoded elsewhere (see AssetLoader); returns the index like load(fileName).
+	// Empty samples give a silent sound.
+	std::size_t load(const PcmData &pcm, const SoundParams &params = SoundParams()) {
+		return mixer.add(pcm, params);
 	}
 
 
+	// Never blocks; a sound already playing overlaps itself up to its maxVoices
 	void play(std::size_t index) {
-		alSourcePlay(sounds[index].first);
+		mixer.play(index);
 	}
 
+	// Streamed background music, crossfaded between tracks
+	MusicPlayer &getMusic() noexcept { return music; }
+
+	const AudioMixer &getMixer() const noexcept { return mixer; }
+	AudioBackend &getBackend() noexcept { return *backend; }
+
 
 	SoundManager(const SoundManager&) = delete;
 	SoundManager(SoundManager&&) = delete;
@@ -71,37 +166,17 @@ public:
 	SoundManager &operator=(SoundManager&&) = delete;
 
 	~SoundManager() {
-		for (auto &p : sounds) {
-			alDeleteBuffers(1, &p.second);
-			alDeleteSources(1, &p.first);
-		}
+		// The audio thread must stop before the mixer and the context go
+		backend.reset();
+		if (alut)
+			alutExit();
 	}
 private:
-	SoundManager(int argc, char *argv[]) {
-		if (!alutInit(&argc, argv)) {
-			fprintf(stderr, "ALUT error: %s\n",
-				alutGetErrorString(alutGetError()));
-			exit(EXIT_FAILURE);
-		}
-
-		ALfloat listenerPos[] = { 0.0, 0.0, 0.0 };
-		ALfloat listenerVel[] = { 0.0, 0.0, 0.0 };
-		ALfloat listenerOri[] = { 0.0, 0.0, -1.0,  0.0, 1.0, 0.0 }; // (first 3 elements are "at", second 3 are "up")  
-		alListenerfv(AL_POSITION, listenerPos);
-		alListenerfv(AL_VELOCITY, listenerVel);
-		alListenerfv(AL_ORIENTATION, listenerOri);
-	}
-	static std::shared_ptr<SoundManager> pManager;
-	static std::vector<std::pair<ALuint, ALuint>> sounds;  // source & buffer 
-	static std::pair<int, char**> command;
-	static bool isSetUp;
+	AudioMixer mixer;
+	MusicPlayer music;
+	std::unique_ptr<AudioBackend> backend;     // last: its audio thread uses mixer and music
+	bool alut = false;
 };
 
-std::shared_ptr<SoundManager> SoundManager::pManager = nullptr;
-std::vector<std::pair<ALuint, ALuint>> SoundManager::sounds;
-std::pair<int, char**> SoundManager::command;
-bool SoundManager::isSetUp = false;
-
 
 #endif // !SOUNDMANAGER_H
-
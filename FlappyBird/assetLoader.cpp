@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <chrono>
+#include "assetLoader.h"
+
+
+AssetLoader::AssetLoader(TextureCache &textures, ShaderCache &shaders, SoundManager *sound, const AssetPack *pack, std::size_t workers)
+	: textures_(textures), shaders_(shaders), sound_(sound), pack_(pack && pack->isOpen() ? pack : nullptr), jobs_(workers) {}
+
+
+void AssetLoader::texture(const std::string &path) {
+	if (this->textures_.contains(path))
+		return;
+
+	this->assets_.emplace_back(new Asset());
+	Asset *asset = this->assets_.back().get();
+	asset->path = path;
+	if (this->pack_ && this->pack_->texture(path, asset->packed)) {
+		std::lock_guard<std::mutex> lock(this->readyMutex_);
+		this->ready_.push_back(asset);
+		return;
+	}
+	this->jobs_.add([this, asset] {
+		asset->image = Image::decode(asset->path.c_str());
+		std::lock_guard<std::mutex> lock(this->readyMutex_);
+		this->ready_.push_back(asset);
+	});
+}
+
+
+void AssetLoader::sound(const std::string &path, std::size_t &index, const SoundParams &params) {
+	if (!this->sound_)
+		return;
+
+	this->assets_.emplace_back(new Asset());
+	Asset *asset = this->assets_.back().get();
+	asset->path = path;
+	asset->index = &index;
+	asset->params = params;
+	if (this->pack_ && this->pack_->sound(path, asset->pcm)) {
+		std::lock_guard<std::mutex> lock(this->readyMutex_);
+		this->ready_.push_back(asset);
+		return;
+	}
+	this->jobs_.add([this, asset] {
+		std::vector<std::uint8_t> bytes;
+		if (readFile(asset->path, bytes) && !decodeWav(bytes.data(), bytes.size(), asset->pcm)) {
+			std::cerr << "ERROR: in " << __FILE__
+				<< " line " << __LINE__
+				<< ": unsupported wav " << asset->path << std::endl;
+		}
+		std::lock_guard<std::mutex> lock(this->readyMutex_);
+		this->ready_.push_back(asset);
+	});
+}
+
+
+Shader &AssetLoader::shader(const char *vertexPath, const char *fragmentPath) {
+	std::string vertexCode, fragmentCode;
+	if (!this->pack_ || !this->pack_->text(vertexPath, vertexCode) || !this->pack_->text(fragmentPath, fragmentCode)) {
+		std::vector<std::uint8_t> vertex, fragment;
+		readFile(vertexPath, vertex);
+		readFile(fragmentPath, fragment);
+		vertexCode.assign(vertex.begin(), vertex.end());
+		fragmentCode.assign(fragment.begin(), fragment.end());
+	}
+	Shader &shader = this->shaders_.get(vertexCode, fragmentCode);
+	this->shaders_.watch(vertexPath, fragmentPath, shader);
+	return shader;
+}
+
+
+void AssetLoader::task(std::function<void()> fn) {
+	this->tasks_.push_back(std::move(fn));
+	++this->tasksTotal_;
+}
+
+
+bool AssetLoader::pump(double budgetMs) {
+	using clock = std::chrono::steady_clock;
+	auto end = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::milli>(budgetMs));
+
+	bool first = true;
+	while (this->uploaded_ < this->assets_.size()) {
+		if (this->uploading_.empty()) {
+			std::lock_guard<std::mutex> lock(this->readyMutex_);
+			this->uploading_.swap(this->ready_);
+		}
+		if (this->uploading_.empty())
+			return false;     // workers still decoding
+
+		if (!first && clock::now() >= end)
+			return false;
+		first = false;
+
+		Asset *asset = this->uploading_.back();
+		this->uploading_.pop_back();
+		this->upload(*asset);
+		++this->uploaded_;
+	}
+
+	while (!this->tasks_.empty()) {
+		if (!first && clock::now() >= end)
+			return false;
+		first = false;
+
+		auto fn = std::move(this->tasks_.front());
+		this->tasks_.pop_front();
+		fn();
+		++this->tasksRun_;
+	}
+	return true;
+}
+
+
+void AssetLoader::upload(Asset &asset) {
+	if (asset.index) {
+		*asset.index = this->sound_->load(asset.pcm, asset.params);   // silent when decoding failed
+	}
+	else if (asset.packed.pixels) {
+		this->textures_.put(asset.path, asset.packed.width, asset.packed.height, asset.packed.levels, asset.packed.pixels);
+	}
+	else {
+		this->textures_.put(asset.path, asset.image);
+	}
+
+	// CPU copies are not needed any more
+	asset.image = Image();
+	asset.pcm = PcmData();
+	asset.packed = PackTexture();
+}
+
+
+bool AssetLoader::done() const noexcept {
+	return this->uploaded_ == this->assets_.size() && this->tasks_.empty();
+}
+
+
+float AssetLoader::progress() const noexcept {
+	std::size_t total = this->assets_.size() + this->tasksTotal_;
+	if (total == 0)
+		return 1.0f;
+	return static_cast<float>(this->uploaded_ + this->tasksRun_) / total;
+}
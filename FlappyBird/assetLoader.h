@@ -0,0 +1,85 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "textureCache.h"
+#include "shaderCache.h"
+#include "assetPack.h"
+#include "SoundManager.h"
+#include "wavFile.h"
+#include "jobSystem.h"
+
+
+/*
+\  Startup asset pipeline. Images and sounds are decoded into CPU buffers on
+\  worker threads as soon as they are queued; the render thread then calls
+\  pump() once per frame, which uploads finished assets and afterwards runs the
+\  queued render-thread tasks (shader compiles, world setup) within a time budget.
+\  Assets found in the AssetPack skip decoding: their textures are uploaded
+\  with the mip chain built offline, straight from the mapped file.
+*/
+class AssetLoader {
+public:
+	// sound may be null when running without audio, pack null or closed to use loose files
+	AssetLoader(TextureCache &textures, ShaderCache &shaders, SoundManager *sound, const AssetPack *pack = nullptr, std::size_t workers = 0);
+	~AssetLoader() = default;
+
+	AssetLoader(const AssetLoader &) = delete;
+	AssetLoader(AssetLoader &&) = delete;
+	AssetLoader& operator=(const AssetLoader &) = delete;
+	AssetLoader& operator=(AssetLoader &&) = delete;
+
+	// Decode on a worker, upload into the TextureCache under the same path
+	void texture(const std::string &path);
+	// Decode on a worker, then index receives the SoundManager index
+	void sound(const std::string &path, std::size_t &index, const SoundParams &params = SoundParams());
+	// Program from the ShaderCache, with the sources read from the pack when it
+	// holds both, else from the files; watched for changes when the cache watches files
+	Shader &shader(const char *vertexPath, const char *fragmentPath);
+	// Runs on the render thread after every texture and sound is uploaded, in order
+	void task(std::function<void()> fn);
+
+	// Upload / run for about budgetMs (at least one step); true once everything is done
+	bool pump(double budgetMs);
+
+	bool done() const noexcept;
+	// 0 .. 1, counting uploads and tasks alike
+	float progress() const noexcept;
+
+private:
+	struct Asset {
+		std::string path;
+		std::size_t *index = nullptr;     // sounds only
+		SoundParams params;
+		Image image;
+		PackTexture packed;               // pixels point into the pack when found there
+		PcmData pcm;
+	};
+
+	void upload(Asset &asset);
+
+	TextureCache &textures_;
+	ShaderCache &shaders_;
+	SoundManager *sound_;
+	const AssetPack *pack_;
+
+	std::vector<std::unique_ptr<Asset>> assets_;   // stable addresses for the workers
+	std::mutex readyMutex_;
+	std::vector<Asset*> ready_;                   // decoded, waiting for upload
+	std::vector<Asset*> uploading_;               // taken from ready_ by pump()
+	std::deque<std::function<void()>> tasks_;
+	std::size_t uploaded_ = 0;
+	std::size_t tasksRun_ = 0;
+	std::size_t tasksTotal_ = 0;
+
+	// Declared last: its destructor waits for the decode jobs while the rest still exists
+	JobSystem jobs_;
+};
+
+#endif // !ASSETLOADER_H
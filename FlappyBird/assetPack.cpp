@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "assetPack.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+static_assert(sizeof(PackEntry) == 40, "PackEntry is stored as is");
+
+constexpr std::uint32_t AssetPack::MAGIC;
+constexpr std::uint32_t AssetPack::VERSION;
+constexpr std::size_t AssetPack::HEADER_SIZE;
+
+
+namespace {
+	constexpr std::size_t ALIGNMENT = 16;
+
+	std::uint32_t get32(const std::uint8_t *p) {
+		return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+	}
+
+	void put32(std::ostream &out, std::uint32_t v) {
+		char bytes[4] = { static_cast<char>(v), static_cast<char>(v >> 8), static_cast<char>(v >> 16), static_cast<char>(v >> 24) };
+		out.write(bytes, 4);
+	}
+
+	// Map the whole file read-only; null when it cannot be opened
+	const std::uint8_t *mapFile(const std::string &path, std::size_t &size) {
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return nullptr;
+		LARGE_INTEGER length;
+		const void *view = nullptr;
+		if (GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping) {
+				view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);     // the view keeps the mapping alive
+			}
+		}
+		CloseHandle(file);
+		size = view ? static_cast<std::size_t>(length.QuadPart) : 0;
+		return static_cast<const std::uint8_t*>(view);
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return nullptr;
+		struct stat st;
+		void *view = MAP_FAILED;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+			view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (view == MAP_FAILED)
+			return nullptr;
+		size = static_cast<std::size_t>(st.st_size);
+		// Everything is read once at startup: fetch it ahead in large sequential reads
+		madvise(view, size, MADV_WILLNEED);
+		return static_cast<const std::uint8_t*>(view);
+#endif
+	}
+
+	void unmapFile(const std::uint8_t *data, std::size_t size) {
+#ifdef _WIN32
+		(void)size;
+		UnmapViewOfFile(data);
+#else
+		munmap(const_cast<std::uint8_t*>(data), size);
+#endif
+	}
+
+	// Half size level from a 2x2 box; odd edges repeat their last texel
+	void downsample(const std::uint8_t *src, int width, int height, std::uint8_t *dst) {
+		int w = PackTexture::levelSize(width, 1), h = PackTexture::levelSize(height, 1);
+		for (int y = 0; y < h; ++y) {
+			int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+			for (int x = 0; x < w; ++x) {
+				int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+				for (int c = 0; c < 4; ++c) {
+					int sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c]
+						+ src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+					dst[(y * w + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+
+std::size_t PackTexture::chainSize(int width, int height, int levels) noexcept {
+	std::size_t size = 0;
+	for (int i = 0; i < levels; ++i)
+		size += static_cast<std::size_t>(levelSize(width, i)) * levelSize(height, i) * 4;
+	return size;
+}
+
+
+bool AssetPack::open(const std::string &path) {
+	this->close();
+
+	std::size_t size = 0;
+	const std::uint8_t *data = mapFile(path, size);
+	if (!data)
+		return false;
+
+	bool valid = size >= HEADER_SIZE && get32(data) == MAGIC && get32(data + 4) == VERSION;
+	std::size_t count = valid ? get32(data + 8) : 0;
+	valid = valid && count <= (size - HEADER_SIZE) / sizeof(PackEntry);
+	const PackEntry *table = reinterpret_cast<const PackEntry*>(data + HEADER_SIZE);
+	for (std::size_t i = 0; valid && i < count; ++i) {
+		const PackEntry &e = table[i];
+		valid = e.offset <= size && e.size <= size - e.offset && (i == 0 || table[i - 1].hash < e.hash);
+	}
+	if (!valid) {
+		std::cerr << "ERROR: in " << __FILE__
+			<< " line " << __LINE__
+			<< ": " << path << " is not a version " << VERSION << " asset pack" << std::endl;
+		unmapFile(data, size);
+		return false;
+	}
+
+	this->data_ = data;
+	this->size_ = size;
+	this->table_ = table;
+	this->count_ = count;
+	return true;
+}
+
+
+void AssetPack::close() noexcept {
+	if (this->data_)
+		unmapFile(this->data_, this->size_);
+	this->data_ = nullptr;
+	this->size_ = 0;
+	this->table_ = nullptr;
+	this->count_ = 0;
+}
+
+
+bool AssetPack::texture(const std::string &path, PackTexture &texture) const {
+	const PackEntry *e = this->find(path, PackType::Texture);
+	if (!e)
+		return false;
+	int width = static_cast<int>(e->info[0]), height = static_cast<int>(e->info[1]), levels = static_cast<int>(e->info[2]);
+	if (width <= 0 || height <= 0 || levels <= 0 || levels > 32 || PackTexture::chainSize(width, height, levels) != e->size)
+		return false;
+
+	texture.width = width;
+	texture.height = height;
+	texture.levels = levels;
+	texture.pixels = this->data_ + e->offset;
+	return true;
+}
+
+
+bool AssetPack::sound(const std::string &path, PcmData &pcm) const {
+	const PackEntry *e = this->find(path, PackType::Sound);
+	if (!e)
+		return false;
+	int channels = static_cast<int>(e->info[0]), bits = static_cast<int>(e->info[2]);
+	if ((channels != 1 && channels != 2) || (bits != 8 && bits != 16))
+		return false;
+
+	pcm.channels = channels;
+	pcm.sampleRate = static_cast<int>(e->info[1]);
+	pcm.bitsPerSample = bits;
+	const std::uint8_t *samples = this->data_ + e->offset;
+	pcm.samples.assign(samples, samples + e->size);
+	return true;
+}
+
+
+bool AssetPack::text(const std::string &path, std::string &text) const {
+	const PackEntry *e = this->find(path, PackType::Text);
+	if (!e)
+		return false;
+	text.assign(reinterpret_cast<const char*>(this->data_ + e->offset), static_cast<std::size_t>(e->size));
+	return true;
+}
+
+
+std::uint64_t AssetPack::hash(const std::string &path) noexcept {
+	std::uint64_t h = 14695981039346656037ull;
+	char last = 0;
+	for (char c : path) {
+		if (c == '\\')
+			c = '/';
+		if (c == '/' && last == '/')
+			continue;
+		h = (h ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+		last = c;
+	}
+	return h;
+}
+
+
+const PackEntry *AssetPack::find(const std::string &path, PackType type) const noexcept {
+	std::uint64_t h = hash(path);
+	const PackEntry *end = this->table_ + this->count_;
+	const PackEntry *e = std::lower_bound(this->table_, end, h,
+		[](const PackEntry &entry, std::uint64_t key) { return entry.hash < key; });
+	if (e == end || e->hash != h || e->type != type)
+		return nullptr;
+	return e;
+}
+
+
+bool AssetPackWriter::addTexture(const std::string &path, int width, int height, const std::uint8_t *rgba) {
+	if (width <= 0 || height <= 0 || !rgba)
+		return false;
+
+	int levels = 1;
+	while (PackTexture::levelSize(width, levels - 1) > 1 || PackTexture::levelSize(height, levels - 1) > 1)
+		++levels;
+
+	Item item;
+	item.entry.type = PackType::Texture;
+	item.entry.info[0] = static_cast<std::uint32_t>(width);
+	item.entry.info[1] = static_cast<std::uint32_t>(height);
+	item.entry.info[2] = static_cast<std::uint32_t>(levels);
+	item.data.resize(PackTexture::chainSize(width, height, levels));
+	std::memcpy(item.data.data(), rgba, static_cast<std::size_t>(width) * height * 4);
+
+	std::size_t offset = 0;
+	for (int i = 0; i + 1 < levels; ++i) {
+		int w = PackTexture::levelSize(width, i), h = PackTexture::levelSize(height, i);
+		std::size_t next = offset + static_cast<std::size_t>(w) * h * 4;
+		downsample(item.data.data() + offset, w, h, item.data.data() + next);
+		offset = next;
+	}
+	return this->add(path, std::move(item));
+}
+
+
+bool AssetPackWriter::addSound(const std::string &path, const PcmData &pcm) {
+	if (pcm.empty())
+		return false;
+
+	Item item;
+	item.entry.type = PackType::Sound;
+	item.entry.info[0] = static_cast<std::uint32_t>(pcm.channels);
+	item.entry.info[1] = static_cast<std::uint32_t>(pcm.sampleRate);
+	item.entry.info[2] = static_cast<std::uint32_t>(pcm.bitsPerSample);
+	item.data = pcm.samples;
+	return this->add(path, std::move(item));
+}
+
+
+bool AssetPackWriter::addText(const std::string &path, const std::string &text) {
+	Item item;
+	item.entry.type = PackType::Text;
+	item.entry.info[0] = item.entry.info[1] = item.entry.info[2] = 0;
+	item.data.assign(text.begin(), text.end());
+	return this->add(path, std::move(item));
+}
+
+
+bool AssetPackWriter::add(const std::string &path, Item item) {
+	item.entry.hash = AssetPack::hash(path);
+	for (const Item &i : this->items_) {
+		if (i.entry.hash == item.entry.hash) {
+			std::cerr << "ERROR: in " << __FILE__
+				<< " line " << __LINE__
+				<< ": " << path << " is already in the pack" << std::endl;
+			return false;
+		}
+	}
+	item.entry.size = item.data.size();
+	this->items_.push_back(std::move(item));
+	return true;
+}
+
+
+bool AssetPackWriter::write(const std::string &path) const {
+	std::vector<const Item*> sorted;
+	for (const Item &i : this->items_)
+		sorted.push_back(&i);
+	std::sort(sorted.begin(), sorted.end(), [](const Item *a, const Item *b) { return a->entry.hash < b->entry.hash; });
+
+	std::vector<PackEntry> table;
+	std::uint64_t offset = AssetPack::HEADER_SIZE + sorted.size() * sizeof(PackEntry);
+	for (const Item *i : sorted) {
+		offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		table.push_back(i->entry);
+		table.back().offset = offset;
+		offset += i->entry.size;
+	}
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		std::cerr << "ERROR: in " << __FILE__
+			<< " line " << __LINE__
+			<< ": failed to create " << path << std::endl;
+		return false;
+	}
+	put32(out, AssetPack::MAGIC);
+	put32(out, AssetPack::VERSION);
+	put32(out, static_cast<std::uint32_t>(table.size()));
+	put32(out, 0);
+	out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(PackEntry)));
+
+	static const char zeros[ALIGNMENT] = {};
+	for (std::size_t i = 0; i < sorted.size(); ++i) {
+		auto pos = static_cast<std::uint64_t>(out.tellp());
+		out.write(zeros, static_cast<std::streamsize>(table[i].offset - pos));
+		out.write(reinterpret_cast<const char*>(sorted[i]->data.data()), static_cast<std::streamsize>(sorted[i]->data.size()));
+	}
+	return static_cast<bool>(out);
+}
@@ -0,0 +1,112 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "wavFile.h"
+
+
+enum class PackType : std::uint32_t { Texture = 1, Sound = 2, Text = 3 };
+
+
+// One table entry, stored as is in the file (little endian)
+struct PackEntry {
+	std::uint64_t hash;       // AssetPack::hash of the asset path
+	PackType type;
+	std::uint32_t info[3];    // texture: width, height, levels; sound: channels, sampleRate, bitsPerSample
+	std::uint64_t offset;     // from the start of the file, 16 byte aligned
+	std::uint64_t size;
+};
+
+
+// RGBA8 mip chain inside the pack: level 0 first, each level halves (to at least 1)
+struct PackTexture {
+	int width = 0;
+	int height = 0;
+	int levels = 0;
+	const std::uint8_t *pixels = nullptr;
+
+	static int levelSize(int size, int level) noexcept { return size >> level > 0 ? size >> level : 1; }
+	// Bytes of a whole chain
+	static std::size_t chainSize(int width, int height, int levels) noexcept;
+};
+
+
+/*
+\  Read-only view of a pack built by AssetPackWriter (FlappyBird --pack).
+\  The file is mapped into memory, so opening costs one mapping and the
+\  assets are handed out straight from the page cache: textures as ready
+\  mip chains for glTexImage2D, sounds as PCM, shaders as source text.
+\
+\  file   header   magic:u32 version:u32 count:u32 0:u32
+\         entries  PackEntry[count], sorted by hash
+\         data     blobs, each 16 byte aligned
+*/
+class AssetPack {
+public:
+	static constexpr std::uint32_t MAGIC = 0x4b504246;    // "FBPK"
+	static constexpr std::uint32_t VERSION = 1;
+	static constexpr std::size_t HEADER_SIZE = 16;
+
+	AssetPack() = default;
+	~AssetPack() { this->close(); }
+
+	AssetPack(const AssetPack &) = delete;
+	AssetPack(AssetPack &&) = delete;
+	AssetPack& operator=(const AssetPack &) = delete;
+	AssetPack& operator=(AssetPack &&) = delete;
+
+	// False (and stays closed) when the file is missing, broken or of another VERSION
+	bool open(const std::string &path);
+	void close() noexcept;
+
+	bool isOpen() const noexcept { return this->data_ != nullptr; }
+	std::size_t entries() const noexcept { return this->count_; }
+
+	// Each returns false when the path is not in the pack as that type.
+	// texture points into the mapping and stays valid until close().
+	bool texture(const std::string &path, PackTexture &texture) const;
+	bool sound(const std::string &path, PcmData &pcm) const;
+	bool text(const std::string &path, std::string &text) const;
+
+	// FNV-1a of the path with '\' and repeated '/' folded, so "a//b" and "a\b" match
+	static std::uint64_t hash(const std::string &path) noexcept;
+
+private:
+	const PackEntry *find(const std::string &path, PackType type) const noexcept;
+
+	const std::uint8_t *data_ = nullptr;
+	std::size_t size_ = 0;
+	const PackEntry *table_ = nullptr;
+	std::size_t count_ = 0;
+};
+
+
+// Builds a pack file from decoded assets; used offline by FlappyBird --pack
+class AssetPackWriter {
+public:
+	// Each returns false when the path (or its hash) is already in the pack.
+	// rgba is width * height * 4 bytes; the mip chain is box filtered here.
+	bool addTexture(const std::string &path, int width, int height, const std::uint8_t *rgba);
+	bool addSound(const std::string &path, const PcmData &pcm);
+	bool addText(const std::string &path, const std::string &text);
+
+	// False when the file cannot be written
+	bool write(const std::string &path) const;
+
+	std::size_t entries() const noexcept { return this->items_.size(); }
+
+private:
+	struct Item {
+		PackEntry entry;
+		std::vector<std::uint8_t> data;
+	};
+
+	bool add(const std::string &path, Item item);
+
+	std::vector<Item> items_;
+};
+
+#endif // !ASSETPACK_H
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <vector>
+#include "audioBackend.h"
+
+
+void NullBackend::start(AudioMixer &mixer) {
+	this->stop();
+	this->running_ = true;
+	this->thread_ = std::thread([this, &mixer] {
+		using clock = std::chrono::steady_clock;
+		std::vector<std::int16_t> period(this->periodFrames_ * AudioMixer::CHANNELS);
+		auto length = std::chrono::duration_cast<clock::duration>(
+			std::chrono::duration<double>(static_cast<double>(this->periodFrames_) / mixer.sampleRate()));
+		auto next = clock::now();
+		while (this->running_) {
+			mixer.render(period.data(), this->periodFrames_);
+			next += length;
+			std::this_thread::sleep_until(next);
+		}
+	});
+}
+
+
+void NullBackend::stop() {
+	this->running_ = false;
+	if (this->thread_.joinable())
+		this->thread_.join();
+}
+
+
+void OfflineBackend::start(AudioMixer &mixer) {
+	this->mixer_ = &mixer;
+	this->recording_.channels = AudioMixer::CHANNELS;
+	this->recording_.sampleRate = mixer.sampleRate();
+	this->recording_.bitsPerSample = 16;
+}
+
+
+void OfflineBackend::advance(std::size_t frames) {
+	if (!this->mixer_ || frames == 0)
+		return;
+	std::size_t bytes = frames * AudioMixer::CHANNELS * sizeof(std::int16_t);
+	std::size_t at = this->recording_.samples.size();
+	this->recording_.samples.resize(at + bytes);
+	std::vector<std::int16_t> block(frames * AudioMixer::CHANNELS);
+	this->mixer_->render(block.data(), frames);
+	// PcmData is little endian bytes
+	for (std::size_t i = 0; i < block.size(); ++i) {
+		this->recording_.samples[at + 2 * i] = static_cast<std::uint8_t>(block[i]);
+		this->recording_.samples[at + 2 * i + 1] = static_cast<std::uint8_t>(static_cast<std::uint16_t>(block[i]) >> 8);
+	}
+}
+
+
+void OfflineBackend::tick(int ticksPerSecond) {
+	if (!this->mixer_ || ticksPerSecond <= 0)
+		return;
+	++this->ticks_;
+	std::uint64_t end = this->ticks_ * static_cast<std::uint64_t>(this->mixer_->sampleRate()) / static_cast<std::uint64_t>(ticksPerSecond);
+	this->advance(static_cast<std::size_t>(end - this->tickFrames_));
+	this->tickFrames_ = end;
+}
+
+
+void OfflineBackend::clear() noexcept {
+	this->recording_.samples.clear();
+	this->ticks_ = 0;
+	this->tickFrames_ = 0;
+}
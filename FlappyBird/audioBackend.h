@@ -0,0 +1,81 @@
+#ifndef AUDIOBACKEND_H
+#define AUDIOBACKEND_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include "audioMixer.h"
+
+
+// Pulls mixed audio out of an AudioMixer and sends it somewhere
+class AudioBackend {
+public:
+	virtual ~AudioBackend() = default;
+
+	// Begin pulling from mixer, which must outlive stop()
+	virtual void start(AudioMixer &mixer) = 0;
+	virtual void stop() = 0;
+};
+
+
+/*
+\  Backend without a device: a thread renders periods at real-time pace and
+\  throws them away, so voices start, steal and finish exactly as they would
+\  on a sound card. For machines with no audio.
+*/
+class NullBackend : public AudioBackend {
+public:
+	explicit NullBackend(std::size_t periodFrames = 512) : periodFrames_(periodFrames) {}
+	~NullBackend() override { this->stop(); }
+
+	NullBackend(const NullBackend &) = delete;
+	NullBackend(NullBackend &&) = delete;
+	NullBackend& operator=(const NullBackend &) = delete;
+	NullBackend& operator=(NullBackend &&) = delete;
+
+	void start(AudioMixer &mixer) override;
+	void stop() override;
+
+private:
+	std::size_t periodFrames_;
+	std::atomic<bool> running_{ false };
+	std::thread thread_;
+};
+
+/*
+\  Backend driven by the caller instead of a clock: nothing is rendered until
+\  advance() or tick(), and everything rendered is kept as PCM. Commands
+\  queued before a call start at its first frame, so a replay that plays the
+\  same sounds between the same ticks gives the same samples every time.
+\  Needs no audio device; for tests, CI and recording replays to WAV.
+*/
+class OfflineBackend : public AudioBackend {
+public:
+	OfflineBackend() = default;
+
+	OfflineBackend(const OfflineBackend &) = delete;
+	OfflineBackend(OfflineBackend &&) = delete;
+	OfflineBackend& operator=(const OfflineBackend &) = delete;
+	OfflineBackend& operator=(OfflineBackend &&) = delete;
+
+	void start(AudioMixer &mixer) override;
+	void stop() override { this->mixer_ = nullptr; }
+
+	// Render frames on the calling thread and append them to the recording
+	void advance(std::size_t frames);
+	// Render one simulation tick; the fractions carry over, so ticksPerSecond
+	// ticks are exactly one second of samples
+	void tick(int ticksPerSecond = 60);
+
+	const PcmData &recording() const noexcept { return this->recording_; }
+	void clear() noexcept;
+
+private:
+	AudioMixer *mixer_ = nullptr;
+	PcmData recording_;
+	std::uint64_t ticks_ = 0;
+	std::uint64_t tickFrames_ = 0;      // frames rendered by tick()
+};
+
+#endif // !AUDIOBACKEND_H
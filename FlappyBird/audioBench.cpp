@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include "audioBench.h"
+#include "audioBackend.h"
+#include "gameSim.h"
+#include "musicPlayer.h"
+
+
+namespace {
+	constexpr std::uint32_t MAX_TICKS = 20000;
+	constexpr std::uint32_t TAIL_TICKS = 60;       // keep rendering after the crash
+	constexpr int TICKS_PER_SECOND = GameRules::TICK_RATE;    // GameConfig's default
+
+	enum { WING, POINT, DIE, HIT, SOUND_COUNT };
+
+	struct Track {
+		PcmData pcm;
+		std::uint32_t firstFlap = 0;     // tick of the first wing sound, 0 for none
+	};
+
+	// One autopilot game rendered tick by tick
+	Track render(const std::vector<PcmData> &pcm, const std::vector<BenchSound> &sounds, unsigned seed) {
+		AudioMixer mixer;
+		for (std::size_t i = 0; i < pcm.size(); ++i)
+			mixer.add(pcm[i], sounds[i].params);
+		OfflineBackend output;
+		output.start(mixer);
+
+		GameConfig config;
+		config.seed = seed;
+		GameSim game(config);
+		std::default_random_engine e(seed);
+		float bias = std::uniform_real_distribution<float>(-60.0f, 20.0f)(e);
+
+		Track track;
+		std::uint32_t tail = 0;
+		while (tail < TAIL_TICKS && game.tick() < MAX_TICKS) {
+			if (game.over()) {
+				++tail;
+			}
+			else {
+				bool flap = game.autoFlap(bias);
+				int score = game.score();
+				game.step(flap);
+				if (flap) {
+					mixer.play(WING);
+					if (track.firstFlap == 0)
+						track.firstFlap = game.tick();
+				}
+				if (game.score() > score)
+					mixer.play(POINT);
+				if (game.over()) {
+					mixer.play(HIT);
+					mixer.play(DIE);
+				}
+			}
+			output.tick(TICKS_PER_SECOND);
+		}
+		output.stop();
+		track.pcm = output.recording();
+		return track;
+	}
+}
+
+
+bool AudioBench::report(std::ostream &os, const std::string &wavPath) const {
+	using clock = std::chrono::steady_clock;
+
+	if (this->sounds_.size() != SOUND_COUNT) {
+		os << "audio bench needs the wing, point, die and hit sounds\n";
+		return false;
+	}
+	std::vector<PcmData> pcm(SOUND_COUNT);
+	for (std::size_t i = 0; i < SOUND_COUNT; ++i) {
+		std::vector<std::uint8_t> bytes;
+		if (!readFile(this->sounds_[i].path, bytes) || !decodeWav(bytes.data(), bytes.size(), pcm[i])) {
+			os << "cannot load " << this->sounds_[i].path << "\n";
+			return false;
+		}
+	}
+
+	// Replays
+	auto start = clock::now();
+	std::size_t frames = 0;
+	Track first;
+	for (std::size_t g = 0; g < this->games_; ++g) {
+		Track track = render(pcm, this->sounds_, this->seed_ + static_cast<unsigned>(g));
+		frames += track.pcm.frames();
+		if (g == 0)
+			first = std::move(track);
+	}
+	double seconds = std::chrono::duration<double>(clock::now() - start).count();
+	double audioSeconds = static_cast<double>(frames) / AudioMixer::SAMPLE_RATE;
+	os << "audio: " << this->games_ << " games, " << std::fixed << std::setprecision(1) << audioSeconds
+		<< " s of audio rendered in " << std::setprecision(3) << seconds << " s ("
+		<< std::setprecision(0) << audioSeconds / std::max(seconds, 1e-9) << "x real time)\n";
+
+	bool deterministic = this->games_ == 0 || render(pcm, this->sounds_, this->seed_).pcm.samples == first.pcm.samples;
+	os << "replay deterministic: " << (deterministic ? "yes" : "NO") << "\n";
+
+	// play() should land on the first frame of the tick that queued it.
+	// The first flap is the first sound of a game; the wing file's own lead-in is not counted.
+	if (first.firstFlap > 0) {
+		auto silentFrames = [](const PcmData &p, std::size_t from) {
+			std::size_t bytesPerFrame = static_cast<std::size_t>(p.channels * p.bitsPerSample / 8);
+			std::size_t at = from;
+			while (at < p.frames() && std::all_of(p.samples.begin() + at * bytesPerFrame, p.samples.begin() + (at + 1) * bytesPerFrame,
+				[](std::uint8_t b) { return b == 0; }))
+				++at;
+			return at - from;
+		};
+		std::size_t tickStart = static_cast<std::size_t>(first.firstFlap - 1) * AudioMixer::SAMPLE_RATE / TICKS_PER_SECOND;
+		long delay = static_cast<long>(silentFrames(first.pcm, tickStart)) - static_cast<long>(silentFrames(pcm[WING], 0));
+		os << "play to first sample: " << delay << " frames after the tick start\n";
+	}
+
+	// Worst case period: every voice busy with the longest sound
+	{
+		AudioMixer mixer;
+		std::size_t longest = 0;
+		for (std::size_t i = 1; i < SOUND_COUNT; ++i)
+			if (pcm[i].frames() > pcm[longest].frames())
+				longest = i;
+		SoundParams unlimited;
+		unlimited.maxVoices = 0;
+		mixer.add(pcm[longest], unlimited);
+		const std::size_t period = 512;
+		std::vector<std::int16_t> out(period * AudioMixer::CHANNELS);
+		std::size_t periods = 0;
+		double busy = 0.0;
+		for (int round = 0; round < 200; ++round) {
+			for (int v = 0; v < 16; ++v)
+				mixer.play(0);
+			auto t = clock::now();
+			mixer.render(out.data(), period);
+			busy += std::chrono::duration<double>(clock::now() - t).count();
+			++periods;
+		}
+		os << "period of " << period << " frames, " << mixer.activeVoices() << " voices: "
+			<< std::setprecision(1) << busy / periods * 1e6 << " us (budget "
+			<< 1e6 * period / mixer.sampleRate() << " us)\n";
+	}
+
+	// Streaming: decode on this thread between periods, so the result is exact
+	bool gapless = true;
+	if (!this->music_.empty()) {
+		std::vector<std::uint8_t> bytes;
+		PcmData track;
+		if (!readFile(this->music_, bytes) || !decodeWav(bytes.data(), bytes.size(), track)
+			|| track.sampleRate != AudioMixer::SAMPLE_RATE || track.bitsPerSample != 16) {
+			os << "cannot stream " << this->music_ << " (needs 16 bit at " << AudioMixer::SAMPLE_RATE << " Hz)\n";
+			return false;
+		}
+		MusicPlayer music(AudioMixer::SAMPLE_RATE, false);
+		music.play(this->music_, true, 0.0f);
+		const std::size_t period = AudioMixer::SAMPLE_RATE / TICKS_PER_SECOND;
+		const std::size_t periods = 60 * TICKS_PER_SECOND;
+		std::vector<float> out(period * AudioMixer::CHANNELS);
+		std::size_t frame = 0, trackFrames = track.frames();
+		for (std::size_t p = 0; p < periods; ++p) {
+			music.decode();
+			std::fill(out.begin(), out.end(), 0.0f);
+			music.mix(out.data(), period);
+			for (std::size_t i = 0; i < period; ++i, ++frame) {
+				std::size_t at = frame % trackFrames;
+				for (int c = 0; c < AudioMixer::CHANNELS; ++c) {
+					std::size_t byte = (at * track.channels + std::min(c, track.channels - 1)) * 2;
+					auto expect = static_cast<std::int16_t>(track.samples[byte] | (track.samples[byte + 1] << 8));
+					gapless = gapless && (p > periods / 2 || out[i * AudioMixer::CHANNELS + c] == expect);
+				}
+			}
+			if (p == periods / 2)
+				music.play(this->music_, true, 0.5f);     // crossfade into a second copy
+		}
+		music.decode();
+		os << "music: " << periods / TICKS_PER_SECOND << " s streamed, " << music.loops() << " loops, "
+			<< music.underruns() << " underrun frames, " << music.tracks() << " track(s) left, ring "
+			<< MusicPlayer::RING_FRAMES * 4 / 1024 << " KB per track, loops gapless: " << (gapless ? "yes" : "NO") << "\n";
+		gapless = gapless && music.underruns() == 0 && music.tracks() == 1;
+	}
+
+	if (!wavPath.empty() && this->games_ > 0) {
+		std::vector<std::uint8_t> bytes;
+		encodeWav(first.pcm, bytes);
+		if (writeFile(wavPath, bytes))
+			os << "first game written to " << wavPath << "\n";
+	}
+	return deterministic && gapless;
+}
@@ -0,0 +1,46 @@
+#ifndef AUDIOBENCH_H
+#define AUDIOBENCH_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "audioMixer.h"
+
+
+// A sound effect of the bench, as the game loads it
+struct BenchSound {
+	std::string path;
+	SoundParams params;
+};
+
+
+/*
+\  Headless audio check: autopilot games are replayed through an AudioMixer
+\  on an OfflineBackend, one tick of samples per GameSim tick, with the sound
+\  effects the game plays for flaps, points and crashes. Reports render speed
+\  against real time, the cost of one output period with every voice busy,
+\  the delay from a play() to its first sample, and whether two renders of
+\  the same replay are identical. A looping MusicPlayer track is streamed
+\  for a minute to check that its loop points are sample exact and that a
+\  crossfade leaves no track behind.
+*/
+class AudioBench {
+public:
+	// sounds: wing, point, die, hit (SharedResources::soundPaths order).
+	// music: a WAV track for the streaming check, skipped when empty.
+	AudioBench(std::size_t games, std::vector<BenchSound> sounds, std::string music = "", unsigned seed = 0)
+		: games_(games), sounds_(std::move(sounds)), music_(std::move(music)), seed_(seed) {}
+
+	// Writes the track of the first game to wavPath unless it is empty.
+	// False when a sound cannot be loaded or the replay is not deterministic.
+	bool report(std::ostream &os, const std::string &wavPath) const;
+
+private:
+	std::size_t games_;
+	std::vector<BenchSound> sounds_;
+	std::string music_;
+	unsigned seed_;
+};
+
+#endif // !AUDIOBENCH_H
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+#include "audioMixer.h"
+
+
+constexpr int AudioMixer::CHANNELS;
+constexpr int AudioMixer::SAMPLE_RATE;
+
+
+namespace {
+	// One channel of one frame as a 16 bit sample
+	std::int16_t sampleAt(const PcmData &pcm, std::size_t frame, int channel) {
+		int c = std::min(channel, pcm.channels - 1);
+		if (pcm.bitsPerSample == 16) {
+			std::size_t i = (frame * pcm.channels + c) * 2;
+			return static_cast<std::int16_t>(pcm.samples[i] | (pcm.samples[i + 1] << 8));
+		}
+		// 8 bit PCM is unsigned
+		return static_cast<std::int16_t>((pcm.samples[frame * pcm.channels + c] - 128) << 8);
+	}
+}
+
+
+AudioMixer::AudioMixer(int sampleRate, std::size_t voices)
+	: sampleRate_(sampleRate), voices_(voices) {}
+
+
+std::size_t AudioMixer::add(const PcmData &pcm, const SoundParams &params) {
+	std::unique_ptr<Sound> sound(new Sound());
+	sound->params = params;
+
+	std::size_t frames = pcm.frames();
+	if (frames > 0 && pcm.sampleRate > 0) {
+		// Linear resampling to the output rate; a plain copy when they match
+		double step = static_cast<double>(pcm.sampleRate) / this->sampleRate_;
+		std::size_t outFrames = static_cast<std::size_t>(frames / step);
+		sound->samples.resize(outFrames * CHANNELS);
+		for (std::size_t i = 0; i < outFrames; ++i) {
+			double at = i * step;
+			std::size_t f0 = static_cast<std::size_t>(at);
+			std::size_t f1 = std::min(f0 + 1, frames - 1);
+			float t = static_cast<float>(at - f0);
+			for (int c = 0; c < CHANNELS; ++c) {
+				float v = sampleAt(pcm, f0, c) * (1.0f - t) + sampleAt(pcm, f1, c) * t;
+				sound->samples[i * CHANNELS + c] = static_cast<std::int16_t>(std::lround(v));
+			}
+		}
+	}
+
+	this->sounds_.push_back(std::move(sound));
+	return this->sounds_.size() - 1;
+}
+
+
+bool AudioMixer::play(std::size_t sound, float gain) {
+	if (sound >= this->sounds_.size() || this->sounds_[sound]->samples.empty())
+		return true;     // nothing to hear
+
+	if (!this->commands_.push({ this->sounds_[sound].get(), gain })) {
+		this->dropped_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+
+void AudioMixer::start(const Command &command) {
+	const Sound *sound = command.sound;
+	Voice *target = nullptr;
+
+	// Over the polyphony limit: restart the oldest instance of the same sound
+	int same = 0;
+	Voice *oldestSame = nullptr;
+	for (Voice &v : this->voices_) {
+		if (v.sound != sound)
+			continue;
+		++same;
+		if (!oldestSame || v.started < oldestSame->started)
+			oldestSame = &v;
+	}
+	if (sound->params.maxVoices > 0 && same >= sound->params.maxVoices)
+		target = oldestSame;
+
+	if (!target) {
+		for (Voice &v : this->voices_) {
+			if (!v.sound) {
+				target = &v;
+				break;
+			}
+		}
+	}
+
+	// Pool full: the lowest priority voice, the oldest among equals
+	if (!target) {
+		for (Voice &v : this->voices_) {
+			if (!target || v.sound->params.priority < target->sound->params.priority
+				|| (v.sound->params.priority == target->sound->params.priority && v.started < target->started))
+				target = &v;
+		}
+		if (!target || target->sound->params.priority > sound->params.priority) {
+			this->dropped_.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	if (target->sound)
+		this->stolen_.fetch_add(1, std::memory_order_relaxed);
+	target->sound = sound;
+	target->position = 0;
+	target->gain = command.gain * sound->params.gain;
+	target->started = this->starts_++;
+	this->played_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void AudioMixer::render(std::int16_t *out, std::size_t frames) {
+	Command command;
+	while (this->commands_.pop(command))
+		this->start(command);
+
+	this->mix_.assign(frames * CHANNELS, 0.0f);
+	std::size_t active = 0;
+	for (Voice &v : this->voices_) {
+		if (!v.sound)
+			continue;
+		const std::int16_t *src = v.sound->samples.data() + v.position * CHANNELS;
+		std::size_t n = std::min(frames, v.sound->frames() - v.position);
+		for (std::size_t i = 0; i < n * CHANNELS; ++i)
+			this->mix_[i] += src[i] * v.gain;
+		v.position += n;
+		if (v.position >= v.sound->frames())
+			v.sound = nullptr;
+		else
+			++active;
+	}
+
+	for (AudioSource *source : this->sources_)
+		source->mix(this->mix_.data(), frames);
+
+	for (std::size_t i = 0; i < frames * CHANNELS; ++i)
+		out[i] = static_cast<std::int16_t>(std::max(-32768.0f, std::min(32767.0f, this->mix_[i])));
+
+	this->active_.store(active, std::memory_order_relaxed);
+	this->frames_.fetch_add(frames, std::memory_order_relaxed);
+}
+
+
+MixerStats AudioMixer::stats() const noexcept {
+	MixerStats s;
+	s.played = this->played_.load(std::memory_order_relaxed);
+	s.stolen = this->stolen_.load(std::memory_order_relaxed);
+	s.dropped = this->dropped_.load(std::memory_order_relaxed);
+	s.frames = this->frames_.load(std::memory_order_relaxed);
+	return s;
+}
@@ -0,0 +1,119 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "spscQueue.h"
+#include "wavFile.h"
+
+
+// How a sound competes for voices
+struct SoundParams {
+	int priority = 0;         // a new sound may steal voices of equal or lower priority
+	int maxVoices = 4;        // instances of this sound playing at once, the oldest is cut beyond
+	float gain = 1.0f;
+};
+
+
+// Anything mixed on top of the voices, e.g. MusicPlayer; called on the audio thread
+class AudioSource {
+public:
+	virtual ~AudioSource() = default;
+	// Add frames of stereo samples to out (frames * 2 floats)
+	virtual void mix(float *out, std::size_t frames) = 0;
+};
+
+
+// Counters since the mixer was created
+struct MixerStats {
+	std::uint64_t played = 0;     // play() calls that got a voice
+	std::uint64_t stolen = 0;     // voices cut off early for a new sound
+	std::uint64_t dropped = 0;    // play() calls lost: queue full or no voice to steal
+	std::uint64_t frames = 0;     // output frames rendered
+};
+
+
+/*
+\  Software mixer: a fixed pool of voices mixed into 16 bit stereo.
+\  The game thread loads sounds and calls play(), which only pushes a command
+\  onto a lock-free queue; the audio thread (an AudioBackend) calls render(),
+\  which takes the commands, assigns voices and mixes. A sound over its
+\  maxVoices replaces its own oldest voice; when the pool is full the lowest
+\  priority, oldest voice is stolen, or the new sound is dropped if every
+\  voice outranks it.
+*/
+class AudioMixer {
+public:
+	static constexpr int CHANNELS = 2;
+	static constexpr int SAMPLE_RATE = 44100;    // default output rate, that of the game's sounds
+
+	explicit AudioMixer(int sampleRate = SAMPLE_RATE, std::size_t voices = 16);
+
+	AudioMixer(const AudioMixer &) = delete;
+	AudioMixer(AudioMixer &&) = delete;
+	AudioMixer& operator=(const AudioMixer &) = delete;
+	AudioMixer& operator=(AudioMixer &&) = delete;
+
+	// Game thread. Converts to the output format once; returns the sound id.
+	// An empty pcm gives a silent sound, so ids stay in load order.
+	std::size_t add(const PcmData &pcm, const SoundParams &params = SoundParams());
+
+	// Game thread, never blocks. False when the command queue is full.
+	bool play(std::size_t sound, float gain = 1.0f);
+
+	// Mix source after the voices on every render(). Not thread safe: attach
+	// before the backend starts. The source must outlive the mixer's use of it.
+	void attach(AudioSource &source) { this->sources_.push_back(&source); }
+
+	// Audio thread: mix the next frames into out (frames * CHANNELS samples)
+	void render(std::int16_t *out, std::size_t frames);
+
+	int sampleRate() const noexcept { return this->sampleRate_; }
+	std::size_t sounds() const noexcept { return this->sounds_.size(); }
+	// Voices playing after the last render()
+	std::size_t activeVoices() const noexcept { return this->active_.load(std::memory_order_relaxed); }
+	MixerStats stats() const noexcept;
+
+private:
+	struct Sound {
+		std::vector<std::int16_t> samples;    // interleaved stereo at sampleRate_
+		SoundParams params;
+		std::size_t frames() const noexcept { return this->samples.size() / CHANNELS; }
+	};
+
+	struct Command {
+		const Sound *sound;
+		float gain;
+	};
+
+	struct Voice {
+		const Sound *sound = nullptr;     // null when free
+		std::size_t position = 0;         // next frame
+		float gain = 1.0f;
+		std::uint64_t started = 0;        // start order, smaller is older
+	};
+
+	void start(const Command &command);
+
+	int sampleRate_;
+	std::vector<std::unique_ptr<Sound>> sounds_;   // stable addresses, only the game thread adds
+	SpscQueue<Command, 256> commands_;
+
+	std::vector<AudioSource*> sources_;
+
+	// Audio thread only
+	std::vector<Voice> voices_;
+	std::vector<float> mix_;
+	std::uint64_t starts_ = 0;
+
+	std::atomic<std::size_t> active_{ 0 };
+	std::atomic<std::uint64_t> played_{ 0 };
+	std::atomic<std::uint64_t> stolen_{ 0 };
+	std::atomic<std::uint64_t> dropped_{ 0 };
+	std::atomic<std::uint64_t> frames_{ 0 };
+};
+
+#endif // !AUDIOMIXER_H
@@ -0,0 +1,132 @@
+#include <limits>
+#include <random>
+#include "birdFlock.h"
+#include "gameRules.h"
+#include "physic.h"
+
+
+namespace {
+	// Wing flutter period in simulation time units, 6 flutters a second
+	constexpr float FLUTTER_PERIOD = 0.0167f;
+	// Speeds between these show the gliding clip, below the falling one
+	constexpr float GLIDE_SPEED = 1000.0f;
+}
+
+
+const SpriteAnimation &BirdFlock::animation() {
+	static const SpriteAnimation birds = [] {
+		SpriteAnimation a;
+		a.addClip({ { Normal, FLUTTER_PERIOD }, { FlutterUpNormal, FLUTTER_PERIOD }, { FlutterDownNormal, FLUTTER_PERIOD } });
+		a.addClip({ { Fly, FLUTTER_PERIOD }, { FlutterUpFly, FLUTTER_PERIOD }, { FlutterDownFly, FLUTTER_PERIOD } });
+		a.addClip({ { Fall, FLUTTER_PERIOD }, { FlutterUpFall, FLUTTER_PERIOD }, { FlutterDownFall, FLUTTER_PERIOD } });
+		// Flapping plays FlyClip directly; the rest follows the vertical speed
+		a.addTransition({ FlyClip, NormalClip, -GLIDE_SPEED, GLIDE_SPEED });
+		a.addTransition({ FallClip, NormalClip, -GLIDE_SPEED, GLIDE_SPEED });
+		a.addTransition({ NormalClip, FallClip, -std::numeric_limits<float>::infinity(), -GLIDE_SPEED });
+		a.addTransition({ FlyClip, FallClip, -std::numeric_limits<float>::infinity(), -GLIDE_SPEED });
+		return a;
+	}();
+	return birds;
+}
+
+
+BirdFlock::BirdFlock(std::size_t count, float x, float y, float halfEdge, unsigned seed, float spread)
+	: halfEdge_(halfEdge),
+	y_(count, y), vy_(count, GameRules::BIRD_START_VELOCITY), bias_(count),
+	minX_(count, x - halfEdge), maxX_(count, x + halfEdge),
+	minY_(count, y - halfEdge), maxY_(count, y + halfEdge),
+	sprites_(count), skin_(count, 0), flap_(count, 0),
+	alive_(utility::BoxBatch::maskWords(count), ~std::uint64_t(0)),
+	hit_(utility::BoxBatch::maskWords(count), 0)
+{
+	if (count & 63)
+		this->alive_.back() = (std::uint64_t(1) << (count & 63)) - 1;
+
+	std::default_random_engine e(seed);
+	std::uniform_real_distribution<float> bias(-spread, spread);
+	for (auto &b : this->bias_)
+		b = bias(e);
+}
+
+
+void BirdFlock::autoFlap(float targetY) noexcept {
+	for (std::size_t i = 0; i < this->size(); ++i) {
+		if (this->vy_[i] <= 0.0f && this->y_[i] < targetY + this->bias_[i])
+			this->flap_[i] = 1;
+	}
+}
+
+
+void BirdFlock::step(float deltaTime) noexcept {
+	const SpriteAnimation &animation = BirdFlock::animation();
+	for (std::size_t i = 0; i < this->size(); ++i) {
+		if (!this->alive(i)) {
+			this->flap_[i] = 0;
+			continue;
+		}
+
+		float v = this->vy_[i];
+		SpritePlayer &sprite = this->sprites_[i];
+		if (this->flap_[i]) {
+			this->flap_[i] = 0;
+			v = utility::Motion::vFlap;
+			animation.play(sprite, FlyClip);
+		}
+
+		float y = this->y_[i] + utility::Motion::displacement(v, deltaTime);
+		v = utility::Motion::velocity(v, deltaTime);
+		animation.update(sprite, v, deltaTime);
+
+		this->y_[i] = y;
+		this->vy_[i] = v;
+		this->minY_[i] = y - this->halfEdge_;
+		this->maxY_[i] = y + this->halfEdge_;
+
+		if (y <= GameRules::OUT_Y)
+			this->alive_[i >> 6] &= ~(std::uint64_t(1) << (i & 63));
+	}
+}
+
+
+std::size_t BirdFlock::collide(const utility::BoxBatch &obstacles) noexcept {
+	// One obstacle against all birds per kernel call
+	for (std::size_t k = 0; k < obstacles.size(); ++k) {
+		std::size_t hits = utility::CollideDetectBatch(
+			obstacles.minX()[k], obstacles.maxX()[k], obstacles.minY()[k], obstacles.maxY()[k],
+			this->minX_.data(), this->maxX_.data(), this->minY_.data(), this->maxY_.data(),
+			this->size(), this->hit_.data());
+		if (!hits)
+			continue;
+		for (std::size_t w = 0; w < this->alive_.size(); ++w)
+			this->alive_[w] &= ~this->hit_[w];
+	}
+	return this->aliveCount();
+}
+
+
+std::size_t BirdFlock::fillInstances(float *out, const SpriteSheet &sheet) const noexcept {
+	const SpriteAnimation &animation = BirdFlock::animation();
+	std::size_t n = 0;
+	for (std::size_t i = 0; i < this->size(); ++i) {
+		if (!this->alive(i))
+			continue;
+		UvRect uv = sheet.uv(this->skin_[i] * FrameCount + animation.cell(this->sprites_[i]));
+		out[6 * n] = this->x(i);
+		out[6 * n + 1] = this->y_[i];
+		out[6 * n + 2] = uv.u0;
+		out[6 * n + 3] = uv.v0;
+		out[6 * n + 4] = uv.u1;
+		out[6 * n + 5] = uv.v1;
+		++n;
+	}
+	return n;
+}
+
+
+std::size_t BirdFlock::aliveCount() const noexcept {
+	std::size_t n = 0;
+	for (auto w : this->alive_)
+		for (; w; w &= w - 1)
+			++n;
+	return n;
+}
@@ -0,0 +1,88 @@
+#ifndef BIRDFLOCK_H
+#define BIRDFLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "collisionBatch.h"
+#include "spriteAnimation.h"
+
+
+/*
+\  Many birds flying through one shared tube course (ghost race / population evaluation).
+\  Bird state lives in contiguous arrays so that physics and collision run as batches.
+*/
+class BirdFlock {
+public:
+	// Animation frames, same order as the bird texture lists in bird.h
+	enum Frame : std::uint8_t {
+		Normal = 0, FlutterDownNormal, FlutterUpNormal,
+		Fly, FlutterDownFly, FlutterUpFly,
+		Fall, FlutterDownFall, FlutterUpFall,
+		FrameCount
+	};
+
+	// Animation clips, each cycles base -> flutter up -> flutter down
+	enum Clip : std::uint8_t { NormalClip = 0, FlyClip, FallClip };
+
+	// Clips and transitions of every bird (player, ghosts, GameSim); cells are Frames
+	static const SpriteAnimation &animation();
+
+	// halfEdge: half size of the collision box, spread: random range of the steering bias
+	BirdFlock(std::size_t count, float x, float y, float halfEdge, unsigned seed = 0, float spread = 120.0f);
+
+	BirdFlock(const BirdFlock &) = default;
+	BirdFlock(BirdFlock &&) = default;
+	BirdFlock& operator=(const BirdFlock &) = default;
+	BirdFlock& operator=(BirdFlock &&) = default;
+	~BirdFlock() = default;
+
+	void flap(std::size_t index) noexcept { this->flap_[index] = 1; }
+
+	// Flap every alive, falling bird that is below targetY + its own bias
+	void autoFlap(float targetY) noexcept;
+
+	// Advance physics and animation of all alive birds
+	void step(float deltaTime) noexcept;
+
+	// Kill every bird overlapping one of the obstacles; returns the number still alive
+	std::size_t collide(const utility::BoxBatch &obstacles) noexcept;
+
+	// Write <x, y, u0, v0, u1, v1> of every alive bird, the UV rect of its
+	// cell skin * FrameCount + frame in sheet; returns the number of instances written
+	std::size_t fillInstances(float *out, const SpriteSheet &sheet) const noexcept;
+
+	void setSkin(std::size_t index, std::uint8_t skin) noexcept { this->skin_[index] = skin; }
+
+	bool alive(std::size_t index) const noexcept {
+		return (this->alive_[index >> 6] >> (index & 63)) & 1;
+	}
+
+	std::size_t size() const noexcept { return this->y_.size(); }
+	std::size_t aliveCount() const noexcept;
+
+	float x(std::size_t index) const noexcept { return this->minX_[index] + this->halfEdge_; }
+	float y(std::size_t index) const noexcept { return this->y_[index]; }
+	float velocityY(std::size_t index) const noexcept { return this->vy_[index]; }
+	std::uint8_t frame(std::size_t index) const noexcept { return animation().cell(this->sprites_[index]); }
+
+private:
+	float halfEdge_;
+
+	std::vector<float> y_;
+	std::vector<float> vy_;
+	std::vector<float> bias_;
+	// Collision boxes in SoA layout, kept in sync with y_
+	std::vector<float> minX_;
+	std::vector<float> maxX_;
+	std::vector<float> minY_;
+	std::vector<float> maxY_;
+	std::vector<SpritePlayer> sprites_;
+	std::vector<std::uint8_t> skin_;
+	std::vector<std::uint8_t> flap_;
+	// One bit per bird
+	std::vector<std::uint64_t> alive_;
+	std::vector<std::uint64_t> hit_;
+};
+
+#endif // !BIRDFLOCK_H
@@ -0,0 +1,167 @@
+#include "bitmapFont.h"
+
+#include <cctype>
+#include <cstring>
+
+
+BitmapFont::BitmapFont(const SpriteSheet &sheet, float glyphWidth, float glyphHeight, float advance, float inset)
+	: sheet_(sheet), glyphWidth_(glyphWidth), glyphHeight_(glyphHeight), advance_(advance), inset_(inset) {
+	this->cells_.fill(-1);
+}
+
+
+void BitmapFont::map(char c, int cell) noexcept {
+	this->cells_[static_cast<unsigned char>(c)] = static_cast<std::int16_t>(cell);
+}
+
+
+void BitmapFont::map(const char *chars, int firstCell) noexcept {
+	for (int i = 0; chars[i]; ++i)
+		this->map(chars[i], firstCell + i);
+}
+
+
+float BitmapFont::width(const std::string &text, float scale) const noexcept {
+	float widest = 0.0f;
+	for (std::size_t first = 0; first <= text.size(); ) {
+		float w = this->lineWidth(text, first, scale);
+		widest = w > widest ? w : widest;
+		std::size_t end = text.find('\n', first);
+		if (end == std::string::npos)
+			break;
+		first = end + 1;
+	}
+	return widest;
+}
+
+
+float BitmapFont::lineWidth(const std::string &text, std::size_t first, float scale) const noexcept {
+	std::size_t end = text.find('\n', first);
+	std::size_t count = (end == std::string::npos ? text.size() : end) - first;
+	if (!count)
+		return 0.0f;
+	// The last glyph takes its own width, not a whole advance
+	return ((count - 1) * this->advance_ + this->glyphWidth_) * scale;
+}
+
+
+std::size_t BitmapFont::layout(const std::string &text, float x, float y, float scale, Align align, std::vector<GlyphQuad> &out) const {
+	std::size_t before = out.size();
+	std::size_t first = 0;
+	float lineY = y;
+	for (;;) {
+		float penX = x;
+		if (align == Center)
+			penX -= this->lineWidth(text, first, scale) / 2.0f;
+		else if (align == Right)
+			penX -= this->lineWidth(text, first, scale);
+
+		std::size_t i = first;
+		for (; i < text.size() && text[i] != '\n'; ++i) {
+			int cell = this->cell(text[i]);
+			if (cell >= 0)
+				out.push_back({ penX, lineY, this->glyphWidth_ * scale, this->glyphHeight_ * scale, this->sheet_.uv(cell, this->inset_) });
+			penX += this->advance_ * scale;
+		}
+
+		if (i >= text.size())
+			break;
+		first = i + 1;
+		// A line apart with a gap of a quarter glyph
+		lineY -= this->glyphHeight_ * scale * 1.25f;
+	}
+	return out.size() - before;
+}
+
+
+const char *const BuiltinFont::CHARS = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.:-/%";
+
+constexpr int BuiltinFont::GLYPH_WIDTH;
+constexpr int BuiltinFont::GLYPH_HEIGHT;
+
+namespace {
+
+// Rows top to bottom, the leftmost pixel in bit 4; in the order of CHARS
+const std::uint8_t GLYPHS[][BuiltinFont::GLYPH_HEIGHT] = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },   // ' '
+	{ 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },   // 0
+	{ 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },
+	{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },
+	{ 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },
+	{ 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },
+	{ 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },
+	{ 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },
+	{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+	{ 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },
+	{ 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },   // 9
+	{ 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 },   // A
+	{ 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },
+	{ 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },
+	{ 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },
+	{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },
+	{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },
+	{ 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },
+	{ 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },
+	{ 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },
+	{ 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },
+	{ 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },
+	{ 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },
+	{ 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },
+	{ 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },
+	{ 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+	{ 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },
+	{ 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },
+	{ 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },
+	{ 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },
+	{ 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },
+	{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+	{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },
+	{ 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },
+	{ 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },
+	{ 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 },
+	{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },   // Z
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C },   // .
+	{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 },   // :
+	{ 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 },   // -
+	{ 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },   // /
+	{ 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },   // %
+};
+
+const int COLUMNS = 16;
+
+}
+
+
+SpriteSheet BuiltinFont::sheet() {
+	int count = static_cast<int>(std::strlen(CHARS));
+	return SpriteSheet(COLUMNS, (count + COLUMNS - 1) / COLUMNS, GLYPH_WIDTH, GLYPH_HEIGHT);
+}
+
+
+std::vector<std::uint8_t> BuiltinFont::pixels() {
+	SpriteSheet sheet = BuiltinFont::sheet();
+	std::vector<std::uint8_t> image(4 * sheet.width() * sheet.height(), 0);
+	int count = static_cast<int>(std::strlen(CHARS));
+	for (int cell = 0; cell < count; ++cell) {
+		for (int row = 0; row < GLYPH_HEIGHT; ++row) {
+			for (int column = 0; column < GLYPH_WIDTH; ++column) {
+				if (!(GLYPHS[cell][row] & (0x10 >> column)))
+					continue;
+				std::size_t at = 4 * ((sheet.y(cell) + row) * sheet.width() + sheet.x(cell) + column);
+				image[at] = image[at + 1] = image[at + 2] = image[at + 3] = 0xFF;
+			}
+		}
+	}
+	return image;
+}
+
+
+BitmapFont BuiltinFont::font(float pixelSize) {
+	// One pixel of space between glyphs; drawn with nearest filtering, so
+	// whole texels
+	BitmapFont font(sheet(), GLYPH_WIDTH * pixelSize, GLYPH_HEIGHT * pixelSize, (GLYPH_WIDTH + 1) * pixelSize, 0.0f);
+	font.map(CHARS, 0);
+	for (char c = 'a'; c <= 'z'; ++c)
+		font.map(c, font.cell(static_cast<char>(std::toupper(static_cast<unsigned char>(c)))));
+	return font;
+}
@@ -0,0 +1,76 @@
+#ifndef BITMAPFONT_H
+#define BITMAPFONT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "spriteAnimation.h"
+
+
+// One glyph to draw: its bottom left corner and size in world units, and
+// where it is in the font's sheet. Eight floats, the layout of a text instance.
+struct GlyphQuad {
+	float x, y;
+	float width, height;
+	UvRect uv;
+};
+
+
+/*
+\  Characters mapped to cells of a SpriteSheet, all glyphs the same size
+\  and advance (a monospaced font, like the score digits). layout() turns
+\  a string of any length into glyph quads, so a whole text is one batch
+\  for one instanced draw. Characters without a cell leave a space.
+*/
+class BitmapFont {
+public:
+	enum Align { Left, Center, Right };
+
+	// glyphWidth, glyphHeight and advance are world units at scale 1;
+	// inset as in SpriteSheet::uv(), 0 for a font drawn with nearest filtering
+	BitmapFont(const SpriteSheet &sheet, float glyphWidth, float glyphHeight, float advance, float inset = 0.5f);
+
+	void map(char c, int cell) noexcept;
+	// chars[i] is cell firstCell + i
+	void map(const char *chars, int firstCell) noexcept;
+	int cell(char c) const noexcept { return this->cells_[static_cast<unsigned char>(c)]; }
+
+	float width(const std::string &text, float scale = 1.0f) const noexcept;
+	float height(float scale = 1.0f) const noexcept { return this->glyphHeight_ * scale; }
+
+	// Append the glyphs of text, its bottom at y and its align edge at x;
+	// '\n' starts a new line below. Returns how many were appended.
+	std::size_t layout(const std::string &text, float x, float y, float scale, Align align, std::vector<GlyphQuad> &out) const;
+
+	const SpriteSheet &sheet() const noexcept { return this->sheet_; }
+
+private:
+	float lineWidth(const std::string &text, std::size_t first, float scale) const noexcept;
+
+	SpriteSheet sheet_;
+	float glyphWidth_, glyphHeight_;
+	float advance_;
+	float inset_;
+	std::array<std::int16_t, 256> cells_;   // -1: no glyph
+};
+
+
+/*
+\  A 5x7 pixel font built into the program for debug text, so it needs no
+\  texture file: digits, capitals (lower case maps to them) and . : - / %.
+\  pixels() is an RGBA image of sheet(), white glyphs on transparent.
+*/
+struct BuiltinFont {
+	static const char *const CHARS;
+	static constexpr int GLYPH_WIDTH = 5;
+	static constexpr int GLYPH_HEIGHT = 7;
+
+	static SpriteSheet sheet();
+	static std::vector<std::uint8_t> pixels();
+	// pixelSize: world units of one font pixel
+	static BitmapFont font(float pixelSize);
+};
+
+#endif // !BITMAPFONT_H
@@ -10,6 +10,7 @@
 #include "drawAble.h"
 #include "shader.h"
 #include "config.h"
+#include "textureCache.h"
 
 
 // ڽĶ
@@ -42,30 +43,15 @@ namespace BoardSp
 */
 class Board : public DrawAble {
 public:
-	Board(const char *tex, const glm::vec3 pos = { 0.0f, 0.0f, 0.0f }, const glm::vec3 scale = { 1.0f, 1.0f, 1.0f })
+	Board(TextureCache &textures, const char *tex, const glm::vec3 pos = { 0.0f, 0.0f, 0.0f }, const glm::vec3 scale = { 1.0f, 1.0f, 1.0f })
 		: Board(pos, scale)
 	{
-		glGenTextures(1, &this->texture_);
-		glBindTexture(GL_TEXTURE_2D, this->texture_);
-
-		int textureWidth, textureHeight;
-		unsigned char* image = SOIL_load_image(tex, &textureWidth, &textureHeight, 0, SOIL_LOAD_RGBA);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		SOIL_free_image_data(image);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		this->texture_ = textures.get(tex);
 	}
 
 	void draw(Shader &shader) override {
 		shader.use();
 
-		glm::mat4 model;
-		model = glm::translate(model, this->position_);
-		model = glm::scale(model, this->scale_);
-		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "model"),
-			1, GL_FALSE, glm::value_ptr(model));
-
 		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "projection"),
 			1, GL_FALSE, glm::value_ptr(PROJECTION));
 
@@ -73,9 +59,33 @@ public:
 		glBindTexture(GL_TEXTURE_2D, texture_);
 		glUniform1i(glGetUniformLocation(shader.getProgram(), "tex"), 0);
 
+		RenderCommand command;
+		command.z = this->position_.z;
+		this->issue(shader, command);
+		glBindVertexArray(0);
+	}
+
+	void submit(RenderQueue &queue, Shader &shader, float z) override {
+		RenderCommand command;
+		command.shader = &shader;
+		command.program = shader.getProgram();
+		command.target = GL_TEXTURE_2D;
+		command.texture = this->texture_;
+		command.z = this->position_.z + z;
+		command.source = this;
+		queue.push(command);
+	}
+
+	// ֻģ;󲢻, ɫѾ
+	void issue(Shader &shader, const RenderCommand &command) override {
+		glm::mat4 model;
+		model = glm::translate(model, glm::vec3(this->position_.x, this->position_.y, command.z));
+		model = glm::scale(model, this->modelScale());
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "model"),
+			1, GL_FALSE, glm::value_ptr(model));
+
 		glBindVertexArray(this->VAO_);
 		glDrawArrays(GL_TRIANGLES, 0, BoardSp::SIZE / 3);
-		glBindVertexArray(0);
 	}
 
 protected:
@@ -100,6 +110,8 @@ protected:
 		glBindVertexArray(0);
 	}
 
+	virtual glm::vec3 modelScale() const { return this->scale_; }
+
 	static const std::unique_ptr <GLfloat, BoardSp::ArrayDelete> vertices_;
 	glm::vec3 position_;
 	const glm::vec3 scale_;
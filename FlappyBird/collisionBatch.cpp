@@ -0,0 +1,190 @@
+#include "collisionBatch.h"
+
+// Every kernel the compiler targets is built, the widest is used
+#if defined(__AVX__) || defined(__AVX2__)
+#define COLLISIONBATCH_AVX
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLLISIONBATCH_SSE
+#include <emmintrin.h>
+#endif
+#if (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define COLLISIONBATCH_NEON
+#include <arm_neon.h>
+#endif
+
+
+namespace utility {
+
+	namespace {
+		// Same predicate as CollideDetect: !(a.maxX < b.minX || a.minX > b.maxX) && ... for Y
+		inline bool overlap(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+			float minX, float maxX, float minY, float maxY) noexcept {
+			return !(boxMaxX < minX || boxMinX > maxX) && !(boxMaxY < minY || boxMinY > maxY);
+		}
+
+		// Returns the hit bits of boxes [first, first + n), n <= 64
+		inline std::uint64_t scalarBits(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+			const float *minX, const float *maxX, const float *minY, const float *maxY,
+			std::size_t first, std::size_t n) noexcept {
+			std::uint64_t bits = 0;
+			for (std::size_t j = 0; j < n; ++j) {
+				std::size_t i = first + j;
+				if (overlap(boxMinX, boxMaxX, boxMinY, boxMaxY, minX[i], maxX[i], minY[i], maxY[i]))
+					bits |= std::uint64_t(1) << j;
+			}
+			return bits;
+		}
+
+		// Block kernels: return the hit bits of the 64 boxes starting at first
+
+		inline std::uint64_t scalarBlockBits(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+			const float *minX, const float *maxX, const float *minY, const float *maxY,
+			std::size_t first) noexcept {
+			return scalarBits(boxMinX, boxMaxX, boxMinY, boxMaxY, minX, maxX, minY, maxY, first, 64);
+		}
+
+#if defined(COLLISIONBATCH_AVX)
+		inline std::uint64_t avxBits(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+			const float *minX, const float *maxX, const float *minY, const float *maxY,
+			std::size_t first) noexcept {
+			// NLT keeps the scalar result for NaN inputs as well
+			const __m256 bMinX = _mm256_set1_ps(boxMinX), bMaxX = _mm256_set1_ps(boxMaxX);
+			const __m256 bMinY = _mm256_set1_ps(boxMinY), bMaxY = _mm256_set1_ps(boxMaxY);
+			std::uint64_t bits = 0;
+			for (std::size_t j = 0; j < 64; j += 8) {
+				std::size_t i = first + j;
+				__m256 x = _mm256_and_ps(
+					_mm256_cmp_ps(bMaxX, _mm256_loadu_ps(minX + i), _CMP_NLT_UQ),
+					_mm256_cmp_ps(_mm256_loadu_ps(maxX + i), bMinX, _CMP_NLT_UQ));
+				__m256 y = _mm256_and_ps(
+					_mm256_cmp_ps(bMaxY, _mm256_loadu_ps(minY + i), _CMP_NLT_UQ),
+					_mm256_cmp_ps(_mm256_loadu_ps(maxY + i), bMinY, _CMP_NLT_UQ));
+				bits |= std::uint64_t(_mm256_movemask_ps(_mm256_and_ps(x, y))) << j;
+			}
+			return bits;
+		}
+#endif
+
+#if defined(COLLISIONBATCH_SSE)
+		inline std::uint64_t sseBits(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+			const float *minX, const float *maxX, const float *minY, const float *maxY,
+			std::size_t first) noexcept {
+			const __m128 bMinX = _mm_set1_ps(boxMinX), bMaxX = _mm_set1_ps(boxMaxX);
+			const __m128 bMinY = _mm_set1_ps(boxMinY), bMaxY = _mm_set1_ps(boxMaxY);
+			std::uint64_t bits = 0;
+			for (std::size_t j = 0; j < 64; j += 4) {
+				std::size_t i = first + j;
+				__m128 x = _mm_and_ps(
+					_mm_cmpnlt_ps(bMaxX, _mm_loadu_ps(minX + i)),
+					_mm_cmpnlt_ps(_mm_loadu_ps(maxX + i), bMinX));
+				__m128 y = _mm_and_ps(
+					_mm_cmpnlt_ps(bMaxY, _mm_loadu_ps(minY + i)),
+					_mm_cmpnlt_ps(_mm_loadu_ps(maxY + i), bMinY));
+				bits |= std::uint64_t(_mm_movemask_ps(_mm_and_ps(x, y))) << j;
+			}
+			return bits;
+		}
+#endif
+
+#if defined(COLLISIONBATCH_NEON)
+		inline std::uint64_t neonBits(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+			const float *minX, const float *maxX, const float *minY, const float *maxY,
+			std::size_t first) noexcept {
+			const float32x4_t bMinX = vdupq_n_f32(boxMinX), bMaxX = vdupq_n_f32(boxMaxX);
+			const float32x4_t bMinY = vdupq_n_f32(boxMinY), bMaxY = vdupq_n_f32(boxMaxY);
+			const int32_t shiftInit[4] = { 0, 1, 2, 3 };
+			const int32x4_t shift = vld1q_s32(shiftInit);
+			std::uint64_t bits = 0;
+			for (std::size_t j = 0; j < 64; j += 4) {
+				std::size_t i = first + j;
+				// miss = (bMaxX < minX) | (maxX < bMinX) | ...
+				uint32x4_t miss = vorrq_u32(
+					vorrq_u32(vcltq_f32(bMaxX, vld1q_f32(minX + i)), vcltq_f32(vld1q_f32(maxX + i), bMinX)),
+					vorrq_u32(vcltq_f32(bMaxY, vld1q_f32(minY + i)), vcltq_f32(vld1q_f32(maxY + i), bMinY)));
+				uint32x4_t hit = vshlq_u32(vshrq_n_u32(vmvnq_u32(miss), 31), shift);
+				bits |= std::uint64_t(vaddvq_u32(hit)) << j;
+			}
+			return bits;
+		}
+#endif
+
+		inline std::size_t popcount(std::uint64_t v) noexcept {
+			std::size_t n = 0;
+			for (; v; v &= v - 1)
+				++n;
+			return n;
+		}
+
+		using BlockBits = std::uint64_t (*)(float, float, float, float,
+			const float *, const float *, const float *, const float *, std::size_t);
+
+		// CollideDetectBatch with Block for whole blocks of 64 and the scalar test for the rest
+		template <BlockBits Block>
+		std::size_t detect(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+			const float *minX, const float *maxX, const float *minY, const float *maxY,
+			std::size_t count, std::uint64_t *mask) noexcept {
+			std::size_t hits = 0;
+			std::size_t full = count / 64;
+			for (std::size_t w = 0; w < full; ++w) {
+				mask[w] = Block(boxMinX, boxMaxX, boxMinY, boxMaxY, minX, maxX, minY, maxY, w * 64);
+				if (mask[w])
+					hits += popcount(mask[w]);
+			}
+
+			std::size_t rest = count - full * 64;
+			if (rest) {
+				mask[full] = scalarBits(boxMinX, boxMaxX, boxMinY, boxMaxY, minX, maxX, minY, maxY, full * 64, rest);
+				hits += popcount(mask[full]);
+			}
+			return hits;
+		}
+	}
+
+
+	std::size_t CollideDetectBatch(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+		const float *minX, const float *maxX, const float *minY, const float *maxY,
+		std::size_t count, std::uint64_t *mask) noexcept {
+#if defined(COLLISIONBATCH_AVX)
+		return detect<avxBits>(boxMinX, boxMaxX, boxMinY, boxMaxY, minX, maxX, minY, maxY, count, mask);
+#elif defined(COLLISIONBATCH_SSE)
+		return detect<sseBits>(boxMinX, boxMaxX, boxMinY, boxMaxY, minX, maxX, minY, maxY, count, mask);
+#elif defined(COLLISIONBATCH_NEON)
+		return detect<neonBits>(boxMinX, boxMaxX, boxMinY, boxMaxY, minX, maxX, minY, maxY, count, mask);
+#else
+		return detect<scalarBlockBits>(boxMinX, boxMaxX, boxMinY, boxMaxY, minX, maxX, minY, maxY, count, mask);
+#endif
+	}
+
+
+	const char *CollideDetectBatchKernel() noexcept {
+#if defined(COLLISIONBATCH_AVX)
+		return "avx";
+#elif defined(COLLISIONBATCH_SSE)
+		return "sse";
+#elif defined(COLLISIONBATCH_NEON)
+		return "neon";
+#else
+		return "scalar";
+#endif
+	}
+
+
+	const std::vector<CollideBatchKernel> &CollideDetectBatchKernels() {
+		static const std::vector<CollideBatchKernel> kernels = {
+#if defined(COLLISIONBATCH_AVX)
+			{ "avx", detect<avxBits> },
+#endif
+#if defined(COLLISIONBATCH_SSE)
+			{ "sse", detect<sseBits> },
+#endif
+#if defined(COLLISIONBATCH_NEON)
+			{ "neon", detect<neonBits> },
+#endif
+			{ "scalar", detect<scalarBlockBits> }
+		};
+		return kernels;
+	}
+
+}
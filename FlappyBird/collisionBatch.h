@@ -0,0 +1,117 @@
+#ifndef COLLISIONBATCH_H
+#define COLLISIONBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "geometry.h"
+
+
+namespace utility {
+
+	// Test one box against count boxes stored as separate min/max arrays (SoA).
+	// Bit i of mask is set when box i overlaps, with the same inclusive edges as
+	// CollideDetect(Rectangle, Rectangle). mask must hold (count + 63) / 64 words.
+	// Returns the number of hits.
+	std::size_t CollideDetectBatch(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+		const float *minX, const float *maxX, const float *minY, const float *maxY,
+		std::size_t count, std::uint64_t *mask) noexcept;
+
+
+	// Name of the kernel selected at compile time ("avx", "sse", "neon" or "scalar")
+	const char *CollideDetectBatchKernel() noexcept;
+
+
+	// One implementation of CollideDetectBatch
+	struct CollideBatchKernel {
+		const char *name;
+		std::size_t (*detect)(float boxMinX, float boxMaxX, float boxMinY, float boxMaxY,
+			const float *minX, const float *maxX, const float *minY, const float *maxY,
+			std::size_t count, std::uint64_t *mask);
+	};
+
+	// Every kernel this build can run, e.g. to test them against each other:
+	// the one CollideDetectBatch uses first, "scalar" last
+	const std::vector<CollideBatchKernel> &CollideDetectBatchKernels();
+
+
+	// AABB set in SoA layout, filled from Geometry projections
+	class BoxBatch {
+	public:
+		static std::size_t maskWords(std::size_t count) noexcept { return (count + 63) / 64; }
+
+		BoxBatch() = default;
+		BoxBatch(const BoxBatch &) = default;
+		BoxBatch(BoxBatch &&) = default;
+		BoxBatch& operator=(const BoxBatch &) = default;
+		BoxBatch& operator=(BoxBatch &&) = default;
+		~BoxBatch() = default;
+
+		void clear() noexcept {
+			minX_.clear();
+			maxX_.clear();
+			minY_.clear();
+			maxY_.clear();
+		}
+
+		void reserve(std::size_t count) {
+			minX_.reserve(count);
+			maxX_.reserve(count);
+			minY_.reserve(count);
+			maxY_.reserve(count);
+		}
+
+		// Returns index of the new box
+		std::size_t add(float minX, float maxX, float minY, float maxY) {
+			minX_.push_back(minX);
+			maxX_.push_back(maxX);
+			minY_.push_back(minY);
+			maxY_.push_back(maxY);
+			return minX_.size() - 1;
+		}
+
+		std::size_t add(const Geometry &geometry) {
+			auto x = geometry.projectToX();
+			auto y = geometry.projectToY();
+			return this->add(x.first, x.second, y.first, y.second);
+		}
+
+		void set(std::size_t index, float minX, float maxX, float minY, float maxY) noexcept {
+			minX_[index] = minX;
+			maxX_[index] = maxX;
+			minY_[index] = minY;
+			maxY_[index] = maxY;
+		}
+
+		std::size_t size() const noexcept { return minX_.size(); }
+
+		// Fills mask (resized to maskWords(size())) and returns the number of hits
+		std::size_t collide(const Geometry &box, std::vector<std::uint64_t> &mask) const {
+			mask.assign(maskWords(this->size()), 0);
+			auto x = box.projectToX();
+			auto y = box.projectToY();
+			return CollideDetectBatch(x.first, x.second, y.first, y.second,
+				minX_.data(), maxX_.data(), minY_.data(), maxY_.data(),
+				this->size(), mask.data());
+		}
+
+		bool collideAny(const Geometry &box) const {
+			thread_local std::vector<std::uint64_t> mask;
+			return this->collide(box, mask) > 0;
+		}
+
+		const float *minX() const noexcept { return minX_.data(); }
+		const float *maxX() const noexcept { return maxX_.data(); }
+		const float *minY() const noexcept { return minY_.data(); }
+		const float *maxY() const noexcept { return maxY_.data(); }
+
+	private:
+		std::vector<float> minX_;
+		std::vector<float> maxX_;
+		std::vector<float> minY_;
+		std::vector<float> maxY_;
+	};
+
+}
+
+#endif // !COLLISIONBATCH_H
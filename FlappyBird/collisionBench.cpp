@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <vector>
+#include "collisionBench.h"
+#include "collisionBatch.h"
+#include "geometry.h"
+
+
+namespace {
+	using utility::Rectangle;
+
+	// Box tests timed per kernel
+	constexpr double TIMED_TESTS = 50e6;
+
+	// Values the comparisons may get wrong: NaN, infinities, signed zero, extremes
+	float special(std::default_random_engine &e) {
+		const float values[] = {
+			std::numeric_limits<float>::quiet_NaN(),
+			std::numeric_limits<float>::infinity(),
+			-std::numeric_limits<float>::infinity(),
+			0.0f, -0.0f,
+			std::numeric_limits<float>::max(),
+			-std::numeric_limits<float>::max(),
+			std::numeric_limits<float>::denorm_min(),
+			1e30f
+		};
+		return values[e() % (sizeof(values) / sizeof(values[0]))];
+	}
+
+	// A random, a grid or an edge case box
+	Rectangle randomBox(std::default_random_engine &e) {
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f), size(0.0f, 200.0f);
+		switch (e() % 4) {
+		case 0:
+			return Rectangle(glm::vec3(position(e), position(e), 0.0f), size(e), size(e));
+		case 1: {
+			// Whole and half units: edges often touch exactly, sizes are often 0
+			auto grid = [&e](int range) { return static_cast<float>(static_cast<int>(e() % (2 * range + 1)) - range) * 0.5f; };
+			return Rectangle(glm::vec3(grid(16), grid(16), 0.0f), std::abs(grid(8)), std::abs(grid(8)));
+		}
+		default: {
+			// Each value a special one a quarter of the time, negative sizes included
+			auto pick = [&e](float usual) { return e() % 4 == 0 ? special(e) : usual; };
+			return Rectangle(glm::vec3(pick(position(e)), pick(position(e)), 0.0f), pick(size(e) - 20.0f), pick(size(e) - 20.0f));
+		}
+		}
+	}
+
+	struct Boxes {
+		std::vector<Rectangle> rects;
+		utility::BoxBatch batch;
+	};
+
+	Boxes makeBoxes(std::size_t count, std::default_random_engine &e) {
+		Boxes boxes;
+		boxes.rects.reserve(count);
+		boxes.batch.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			boxes.rects.push_back(randomBox(e));
+			boxes.batch.add(boxes.rects.back());
+		}
+		return boxes;
+	}
+
+	// The reference: one CollideDetect per box, bits as CollideDetectBatch sets them
+	std::size_t reference(const Rectangle &box, const std::vector<Rectangle> &rects, std::size_t count, std::uint64_t *mask) {
+		std::size_t hits = 0;
+		std::fill(mask, mask + utility::BoxBatch::maskWords(count), 0);
+		for (std::size_t i = 0; i < count; ++i) {
+			if (utility::CollideDetect(box, rects[i])) {
+				mask[i / 64] |= std::uint64_t(1) << (i % 64);
+				++hits;
+			}
+		}
+		return hits;
+	}
+}
+
+
+bool CollisionBench::report(std::ostream &os, std::size_t checkRounds) const {
+	using clock = std::chrono::steady_clock;
+	const std::vector<utility::CollideBatchKernel> &kernels = utility::CollideDetectBatchKernels();
+	std::default_random_engine e(this->seed_);
+
+	// Check: random probes against random prefixes, so tails of every length are covered
+	std::vector<std::size_t> mismatches(kernels.size(), 0);
+	std::size_t tests = 0;
+	{
+		Boxes boxes = makeBoxes(std::max<std::size_t>(this->boxes_, 256), e);
+		std::vector<std::uint64_t> expected(utility::BoxBatch::maskWords(boxes.rects.size()));
+		std::vector<std::uint64_t> mask(expected.size());
+		for (std::size_t round = 0; round < checkRounds; ++round) {
+			Rectangle box = randomBox(e);
+			std::size_t count = round % 2 ? e() % 257 : e() % (boxes.rects.size() + 1);
+			std::size_t hits = reference(box, boxes.rects, count, expected.data());
+			auto x = box.projectToX();
+			auto y = box.projectToY();
+			std::size_t words = utility::BoxBatch::maskWords(count);
+			for (std::size_t k = 0; k < kernels.size(); ++k) {
+				std::size_t got = kernels[k].detect(x.first, x.second, y.first, y.second,
+					boxes.batch.minX(), boxes.batch.maxX(), boxes.batch.minY(), boxes.batch.maxY(), count, mask.data());
+				if (got != hits || !std::equal(mask.begin(), mask.begin() + words, expected.begin()))
+					++mismatches[k];
+			}
+			tests += count;
+		}
+	}
+
+	// Time: the same batch and probes for every kernel and for CollideDetect
+	Boxes boxes = makeBoxes(this->boxes_, e);
+	std::vector<Rectangle> probes;
+	for (int i = 0; i < 16; ++i)
+		probes.push_back(randomBox(e));
+	std::size_t passes = std::max<std::size_t>(1, static_cast<std::size_t>(TIMED_TESTS / this->boxes_));
+	std::vector<std::uint64_t> mask(utility::BoxBatch::maskWords(this->boxes_));
+	std::size_t checksum = 0;
+
+	auto start = clock::now();
+	for (std::size_t pass = 0; pass < passes; ++pass)
+		checksum += reference(probes[pass % probes.size()], boxes.rects, this->boxes_, mask.data());
+	double referenceSeconds = std::chrono::duration<double>(clock::now() - start).count();
+
+	std::vector<double> seconds;
+	for (const auto &kernel : kernels) {
+		start = clock::now();
+		for (std::size_t pass = 0; pass < passes; ++pass) {
+			const Rectangle &box = probes[pass % probes.size()];
+			auto x = box.projectToX();
+			auto y = box.projectToY();
+			checksum += kernel.detect(x.first, x.second, y.first, y.second,
+				boxes.batch.minX(), boxes.batch.maxX(), boxes.batch.minY(), boxes.batch.maxY(), this->boxes_, mask.data());
+		}
+		seconds.push_back(std::chrono::duration<double>(clock::now() - start).count());
+	}
+
+	bool ok = true;
+	double boxTests = static_cast<double>(passes) * this->boxes_;
+	os << "collision kernels: " << tests << " box tests checked, " << this->boxes_ << " boxes timed, "
+		<< "CollideDetectBatch uses " << utility::CollideDetectBatchKernel() << "\n";
+	os << std::setw(14) << "kernel" << std::setw(12) << "M boxes/s" << std::setw(12) << "vs scalar"
+		<< std::setw(18) << "vs CollideDetect" << std::setw(12) << "mismatches" << "\n";
+	os << std::setw(14) << "CollideDetect" << std::setw(12) << std::fixed << std::setprecision(1) << boxTests / referenceSeconds / 1e6
+		<< std::setw(12) << "" << std::setw(18) << "1.0" << std::setw(12) << "-" << "\n";
+	for (std::size_t k = 0; k < kernels.size(); ++k) {
+		ok = ok && mismatches[k] == 0;
+		os << std::setw(14) << kernels[k].name << std::setw(12) << boxTests / seconds[k] / 1e6
+			<< std::setw(12) << seconds.back() / seconds[k]
+			<< std::setw(18) << referenceSeconds / seconds[k]
+			<< std::setw(12) << mismatches[k] << "\n";
+	}
+	// Keeps the timed loops from being optimized away
+	os << "hits " << checksum << "\n";
+	return ok;
+}
@@ -0,0 +1,29 @@
+#ifndef COLLISIONBENCH_H
+#define COLLISIONBENCH_H
+
+#include <cstddef>
+#include <iostream>
+
+
+/*
+\  Offline check of every CollideDetectBatch kernel of the build against
+\  CollideDetect(Rectangle, Rectangle): random boxes, boxes on a coarse grid
+\  (touching edges, empty boxes) and NaN, infinite and huge coordinates,
+\  with batch lengths that are not whole blocks. Then the throughput of
+\  each kernel and its speedup over the scalar ones.
+*/
+class CollisionBench {
+public:
+	// boxes: batch length of the timing pass, and the longest checked
+	CollisionBench(std::size_t boxes, unsigned seed = 0)
+		: boxes_(boxes ? boxes : 1), seed_(seed) {}
+
+	// Returns false when a kernel disagreed with CollideDetect
+	bool report(std::ostream &os, std::size_t checkRounds = 20000) const;
+
+private:
+	std::size_t boxes_;
+	unsigned seed_;
+};
+
+#endif // !COLLISIONBENCH_H
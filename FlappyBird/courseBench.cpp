@@ -0,0 +1,73 @@
+#include <chrono>
+#include <iomanip>
+#include "courseBench.h"
+#include "courseGenerator.h"
+
+
+namespace {
+	enum { UNREACHABLE, NO_ROOM, OUT_OF_RANGE, NOT_AHEAD, NOT_REPEATED, RULE_COUNT };
+
+	const char *const RULE_NAMES[RULE_COUNT] = { "unreachable", "no room", "out of range", "not ahead", "not repeated" };
+
+	bool same(const CourseTube &a, const CourseTube &b) noexcept {
+		return a.x == b.x && a.y == b.y && a.halfSpace == b.halfSpace
+			&& a.amplitude == b.amplitude && a.period == b.period && a.phase == b.phase;
+	}
+}
+
+
+bool CourseBench::report(std::ostream &os) const {
+	using clock = std::chrono::steady_clock;
+	const char *const modes[] = { "easy", "normal", "hard" };
+
+	bool ok = true;
+	os << "courses: " << this->seeds_ << " seeds of " << this->tubes_ << " tubes per mode\n";
+	os << std::setw(8) << "mode" << std::setw(14) << "M tubes/s";
+	for (const char *name : RULE_NAMES)
+		os << std::setw(14) << name;
+	os << "\n";
+
+	for (int mode = 0; mode < 3; ++mode) {
+		std::size_t broken[RULE_COUNT] = {};
+		double seconds = 0.0;
+		for (std::size_t seed = 0; seed < this->seeds_; ++seed) {
+			CourseParams params = CourseParams::forMode(mode, static_cast<unsigned>(seed));
+
+			// The whole course at once, timed
+			auto start = clock::now();
+			CourseGenerator whole(params);
+			whole.ensure(this->tubes_ - 1);
+			seconds += std::chrono::duration<double>(clock::now() - start).count();
+
+			// As a game asks for it: a few tubes ahead, the ones behind released
+			CourseGenerator played(params);
+			// The bird's start, as CourseGenerator::reset() puts it before the first tube
+			CourseTube previous = { 0.0f, params.startY, params.birdHalfEdge, 0.0f, 1.0f, 0.0f };
+			for (std::size_t i = 0; i < this->tubes_; ++i) {
+				played.ensure(i + 4);
+				const CourseTube &tube = played[i];
+				if (!CourseGenerator::reachable(previous, tube, params))
+					++broken[UNREACHABLE];
+				if (CourseGenerator::slack(tube, params) < 0.0f)
+					++broken[NO_ROOM];
+				if (tube.y < params.minY || tube.y > params.maxY)
+					++broken[OUT_OF_RANGE];
+				if (tube.x <= previous.x)
+					++broken[NOT_AHEAD];
+				if (!same(tube, whole[i]))
+					++broken[NOT_REPEATED];
+				previous = tube;
+				played.release(i);
+			}
+		}
+
+		double tubes = static_cast<double>(this->seeds_) * this->tubes_;
+		os << std::setw(8) << modes[mode] << std::setw(14) << std::fixed << std::setprecision(1) << tubes / seconds / 1e6;
+		for (std::size_t count : broken) {
+			os << std::setw(14) << count;
+			ok = ok && count == 0;
+		}
+		os << "\n";
+	}
+	return ok;
+}
@@ -0,0 +1,30 @@
+#ifndef COURSEBENCH_H
+#define COURSEBENCH_H
+
+#include <cstddef>
+#include <iostream>
+
+
+/*
+\  Offline check of CourseGenerator: courses of every game mode for many
+\  seeds, each tube tested against the rules next() promises. Its gap can
+\  be reached from the one before it (the bird's start for the first), the
+\  bird fits through it, its centre is in [minY, maxY], it comes after the
+\  one before it, and a course generated a chunk at a time while the tubes
+\  behind are released is the same as one generated whole.
+*/
+class CourseBench {
+public:
+	// seeds: courses per game mode, tubes: length of each
+	CourseBench(std::size_t seeds, std::size_t tubes = 1000)
+		: seeds_(seeds ? seeds : 1), tubes_(tubes ? tubes : 1) {}
+
+	// Returns false when a tube broke one of the rules
+	bool report(std::ostream &os) const;
+
+private:
+	std::size_t seeds_;
+	std::size_t tubes_;
+};
+
+#endif // !COURSEBENCH_H
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cmath>
+#include "courseGenerator.h"
+#include "physic.h"
+
+
+namespace {
+
+const float TWO_PI = 6.28318531f;
+
+// Height of one flap from where it started to its top
+float hop() noexcept {
+	return utility::Motion::vFlap * utility::Motion::vFlap / (2.0f * utility::Motion::aUp);
+}
+
+}
+
+
+float CourseTube::yAt(float time) const noexcept {
+	if (this->amplitude <= 0.0f)
+		return this->y;
+	return this->y + this->amplitude * std::sin(TWO_PI * time / this->period + this->phase);
+}
+
+
+CourseParams CourseParams::forMode(int mode, unsigned seed) {
+	CourseParams params;
+	params.seed = seed;
+	if (mode == 0) {
+		params.halfSpace = { 180.0f, 160.0f };
+		params.spacing = { 400.0f, 360.0f };
+		params.maxStep = { 160.0f, 240.0f };
+		params.moveChance = { 0.0f, 0.15f };
+		params.moveAmplitude = { 0.0f, 40.0f };
+	}
+	else if (mode == 2) {
+		params.halfSpace = { 130.0f, 110.0f };
+		params.spacing = { 380.0f, 300.0f };
+		params.maxStep = { 240.0f, 400.0f };
+		params.moveChance = { 0.1f, 0.45f };
+		params.moveAmplitude = { 30.0f, 60.0f };
+	}
+	return params;
+}
+
+
+CourseGenerator::CourseGenerator(const CourseParams &params) {
+	this->reset(params);
+}
+
+
+void CourseGenerator::reset(const CourseParams &params) {
+	this->params_ = params;
+	this->engine_.seed(params.seed);
+	this->tubes_.clear();
+	this->first_ = 0;
+	// The bird itself: a gap with no room to spare
+	this->last_ = { 0.0f, params.startY, params.birdHalfEdge, 0.0f, 1.0f, 0.0f };
+}
+
+
+void CourseGenerator::ensure(std::size_t i) {
+	while (this->end() <= i)
+		this->generateChunk();
+}
+
+
+void CourseGenerator::release(std::size_t i) {
+	if (i <= this->first_)
+		return;
+	std::size_t chunk = std::max<std::size_t>(this->params_.chunkSize, 1);
+	std::size_t count = std::min((i - this->first_) / chunk * chunk, this->tubes_.size());
+	this->tubes_.erase(this->tubes_.begin(), this->tubes_.begin() + count);
+	this->first_ += count;
+}
+
+
+float CourseGenerator::slack(const CourseTube &tube, const CourseParams &params) noexcept {
+	return tube.halfSpace - params.birdHalfEdge - tube.amplitude;
+}
+
+
+bool CourseGenerator::reachable(const CourseTube &from, const CourseTube &to, const CourseParams &params) noexcept {
+	std::pair<float, float> range = reachableY(from, to, params);
+	// Allow for rounding in next()
+	return to.y >= range.first - 0.01f && to.y <= range.second + 0.01f;
+}
+
+
+std::pair<float, float> CourseGenerator::reachableY(const CourseTube &from, const CourseTube &to, const CourseParams &params) noexcept {
+	// Time from leaving one gap to entering the next
+	float time = std::max(0.0f, (to.x - from.x - 2.0f * (params.tubeHalfWidth + params.birdHalfEdge)) / params.speed);
+	float climb = 0.5f * utility::Motion::vFlap * time;
+	float fall = 0.5f * utility::Motion::aDown * time * time;
+
+	// The bird may leave anywhere in from's gap and enter anywhere in to's
+	float room = slack(from, params) + slack(to, params);
+	return { from.y - room - fall, from.y + room + climb };
+}
+
+
+void CourseGenerator::generateChunk() {
+	this->tubes_.reserve(this->tubes_.size() + this->params_.chunkSize);
+	for (std::size_t i = 0; i < std::max<std::size_t>(this->params_.chunkSize, 1); ++i) {
+		this->last_ = this->next(this->last_);
+		this->tubes_.push_back(this->last_);
+	}
+}
+
+
+CourseTube CourseGenerator::next(const CourseTube &previous) {
+	const CourseParams &p = this->params_;
+	CourseTube tube;
+	bool first = this->end() == 0;
+	float difficulty = std::min(std::max(previous.x / p.rampDistance, 0.0f), 1.0f);
+
+	tube.x = first ? p.firstX : previous.x + p.spacing.at(difficulty);
+	tube.halfSpace = p.halfSpace.at(difficulty);
+
+	// A moving gap still leaves room for a whole flap
+	bool moving = this->unit() < p.moveChance.at(difficulty);
+	float amplitude = p.moveAmplitude.at(difficulty) * (0.5f + 0.5f * this->unit());
+	tube.amplitude = moving ? std::max(0.0f, std::min(amplitude, tube.halfSpace - p.birdHalfEdge - 0.5f * hop())) : 0.0f;
+	tube.period = p.minPeriod + (p.maxPeriod - p.minPeriod) * this->unit();
+	tube.phase = TWO_PI * this->unit();
+
+	float step = (2.0f * this->unit() - 1.0f) * p.maxStep.at(difficulty);
+	tube.y = std::min(std::max(previous.y + step, p.minY), p.maxY);
+
+	// Pull the gap toward the previous one until a tapping bird can make it
+	// (reachable()); previous.y is in range, so the result stays in range too
+	std::pair<float, float> range = reachableY(previous, tube, p);
+	tube.y = std::min(std::max(tube.y, range.first), range.second);
+	return tube;
+}
+
+
+float CourseGenerator::unit() noexcept {
+	return static_cast<float>(static_cast<std::uint32_t>(this->engine_()) >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,118 @@
+#ifndef COURSEGENERATOR_H
+#define COURSEGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+// One tube of a course. x is in course coordinates: the bird starts at 0
+// and the course scrolls past it; y is the centre of the gap.
+struct CourseTube {
+	float x;
+	float y;
+	float halfSpace;        // half the height of the gap
+	float amplitude;        // up and down movement of the gap, 0 for a still tube
+	float period;           // of the movement, in display()'s time unit (0.0001 * ms)
+	float phase;
+
+	// Gap centre at simulation time
+	float yAt(float time) const noexcept;
+};
+
+
+/*
+\  How a course is laid out. Every Ramp goes from its easy value at the
+\  start to its hard value at rampDistance and stays there. The physics
+\  fields must match the game the course is for.
+*/
+struct CourseParams {
+	struct Ramp {
+		float easy;
+		float hard;
+		float at(float difficulty) const noexcept { return this->easy + (this->hard - this->easy) * difficulty; }
+	};
+
+	unsigned seed = 0;
+	std::size_t chunkSize = 16;     // tubes generated at a time
+
+	float firstX = 500.0f;          // of the first tube
+	float startY = -109.693f;       // of the bird
+	float minY = -240.0f;           // range of the gap centres, as the old fixed layout
+	float maxY = 160.0f;
+	float rampDistance = 40000.0f;  // about 100 tubes
+
+	Ramp spacing{ 400.0f, 330.0f };       // from one tube to the next
+	Ramp halfSpace{ 130.0f, 115.0f };
+	Ramp maxStep{ 200.0f, 320.0f };       // height change between neighbouring gaps
+	Ramp moveChance{ 0.0f, 0.3f };        // that a tube moves
+	Ramp moveAmplitude{ 0.0f, 50.0f };
+	float minPeriod = 0.3f;
+	float maxPeriod = 0.5f;
+
+	float speed = 2500.0f;          // scrolling, course units per time unit
+	float birdHalfEdge = 25.0f;
+	float tubeHalfWidth = 50.0f;
+
+	// Defaults of a game mode: 0 easy, 1 normal, 2 hard (as GameContext::mode)
+	static CourseParams forMode(int mode, unsigned seed = 0);
+};
+
+
+/*
+\  Endless course of tubes, generated a chunk at a time as it is asked
+\  for, so each tube costs O(1) amortized and only the part around the
+\  bird is kept. The same params (seed included) give the same course on
+\  every platform: the engine is mt19937 and its numbers are mapped by
+\  hand, not by the library's distributions.
+\
+\  Every tube is reachable from the one before it: its gap is moved
+\  toward the previous one until a bird that only taps could get there
+\  (see reachable()), and a moving gap always leaves room for one flap.
+*/
+class CourseGenerator {
+public:
+	explicit CourseGenerator(const CourseParams &params = CourseParams());
+
+	void reset(const CourseParams &params);
+
+	// Generate up to and including tube i
+	void ensure(std::size_t i);
+	// Forget whole chunks before tube i; they cannot be asked for again
+	void release(std::size_t i);
+
+	// Tube i, which must be generated and not released
+	const CourseTube &operator[](std::size_t i) const noexcept { return this->tubes_[i - this->first_]; }
+
+	std::size_t first() const noexcept { return this->first_; }
+	// One past the last generated tube
+	std::size_t end() const noexcept { return this->first_ + this->tubes_.size(); }
+	const CourseParams &params() const noexcept { return this->params_; }
+
+	// Room a bird has to move up or down in the gap, whatever its movement
+	static float slack(const CourseTube &tube, const CourseParams &params) noexcept;
+	// Whether a bird through from's gap can get through to's: the climb by
+	// tapping (on average half the flap speed) and the fall from rest in the
+	// time between the two tubes cover the height between their gaps
+	static bool reachable(const CourseTube &from, const CourseTube &to, const CourseParams &params) noexcept;
+
+private:
+	// Lowest and highest gap centre of to (its y aside) that a bird through
+	// from's gap can get to: reachable() tests it, next() clamps to it
+	static std::pair<float, float> reachableY(const CourseTube &from, const CourseTube &to, const CourseParams &params) noexcept;
+
+	void generateChunk();
+	CourseTube next(const CourseTube &previous);
+	// In [0, 1)
+	float unit() noexcept;
+
+	CourseParams params_;
+	std::mt19937 engine_;
+	std::vector<CourseTube> tubes_;     // tubes first_ .. end()
+	std::size_t first_ = 0;
+	CourseTube last_;                   // the bird's start before the first tube
+};
+
+#endif // !COURSEGENERATOR_H
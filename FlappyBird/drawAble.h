@@ -2,6 +2,7 @@
 #define DRAWABLE_H
 
 #include "shader.h"
+#include "renderQueue.h"
 
 class DrawAble {
 public:
@@ -15,6 +16,23 @@ public:
 	virtual ~DrawAble() = default;
 	
 	virtual void draw(Shader &shader) = 0;
+
+	// Queue this object's draws at layer z instead of drawing now.
+	// The default queues one command that draws it whole.
+	virtual void submit(RenderQueue &queue, Shader &shader, float z) {
+		RenderCommand command;
+		command.shader = &shader;
+		command.program = shader.getProgram();
+		command.z = z;
+		command.source = this;
+		queue.push(command);
+	}
+
+	// Issue a command queued by submit(); the renderer has bound its program,
+	// projection and texture
+	virtual void issue(Shader &shader, const RenderCommand &) {
+		this->draw(shader);
+	}
 };
 
 #endif // !DRAWABLE_H
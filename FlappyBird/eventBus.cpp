@@ -0,0 +1,45 @@
+#include <algorithm>
+#include "eventBus.h"
+
+
+constexpr std::size_t EventBus::CAPACITY;
+constexpr std::size_t EventBus::MAX_CONSUMERS;
+
+
+bool EventBus::subscribe(EventConsumer &consumer) noexcept {
+	if (this->consumerCount_ == MAX_CONSUMERS)
+		return false;
+	this->consumers_[this->consumerCount_++] = &consumer;
+	return true;
+}
+
+
+void EventBus::unsubscribe(EventConsumer &consumer) noexcept {
+	auto last = this->consumers_.begin() + this->consumerCount_;
+	auto it = std::remove(this->consumers_.begin(), last, &consumer);
+	this->consumerCount_ = static_cast<std::size_t>(it - this->consumers_.begin());
+}
+
+
+std::size_t EventBus::dispatch() {
+	std::size_t count = this->count_;
+	if (count > 0)
+		for (std::size_t i = 0; i < this->consumerCount_; ++i)
+			this->consumers_[i]->consume(this->events_.data(), count);
+	this->count_ = 0;
+	return count;
+}
+
+
+void EventCounter::consume(const GameEvent *events, std::size_t count) {
+	for (std::size_t i = 0; i < count; ++i)
+		++this->counts_[static_cast<std::size_t>(events[i].type)];
+}
+
+
+void EventCounter::report(std::ostream &os) const {
+	static const char *names[] = { "flap", "score", "hit", "die", "click" };
+	for (std::size_t i = 0; i < this->counts_.size(); ++i)
+		os << (i ? ", " : "") << names[i] << " " << this->counts_[i];
+	os << std::endl;
+}
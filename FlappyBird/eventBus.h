@@ -0,0 +1,93 @@
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+
+enum class EventType : std::uint8_t { Flap, Score, Hit, Die, ButtonClick, Count };
+
+
+// Something that happened during one tick of a game
+struct GameEvent {
+	EventType type;
+	std::uint32_t tick;       // simulation tick it happened on
+	std::int32_t value;       // Score: new score, Hit: 0 tube / 1 out of bounds, Die: final score, ButtonClick: button
+};
+
+
+// Reacts to a tick's events, e.g. audio, particles or telemetry
+class EventConsumer {
+public:
+	virtual ~EventConsumer() = default;
+	virtual void consume(const GameEvent *events, std::size_t count) = 0;
+};
+
+
+/*
+\  Per-game event queue. The simulation only push()es plain records into a
+\  fixed array; after the step dispatch() hands the whole batch to every
+\  subscribed consumer in turn and empties the queue. Nothing allocates, and
+\  with no consumers (headless runs) the events are simply dropped.
+*/
+class EventBus {
+public:
+	static constexpr std::size_t CAPACITY = 64;
+	static constexpr std::size_t MAX_CONSUMERS = 8;
+
+	EventBus() = default;
+
+	EventBus(const EventBus &) = delete;
+	EventBus(EventBus &&) = delete;
+	EventBus& operator=(const EventBus &) = delete;
+	EventBus& operator=(EventBus &&) = delete;
+
+	// False when the queue is full; the event is counted in dropped()
+	bool push(EventType type, std::uint32_t tick, std::int32_t value = 0) noexcept {
+		if (this->count_ == CAPACITY) {
+			++this->dropped_;
+			return false;
+		}
+		this->events_[this->count_++] = { type, tick, value };
+		return true;
+	}
+
+	// consumer must outlive the bus or be unsubscribed; false when full
+	bool subscribe(EventConsumer &consumer) noexcept;
+	void unsubscribe(EventConsumer &consumer) noexcept;
+
+	// Give the queued events to every consumer in subscription order, then
+	// clear the queue. Returns the number of events delivered.
+	std::size_t dispatch();
+	void clear() noexcept { this->count_ = 0; }
+
+	const GameEvent *begin() const noexcept { return this->events_.data(); }
+	const GameEvent *end() const noexcept { return this->events_.data() + this->count_; }
+	std::size_t size() const noexcept { return this->count_; }
+	std::size_t dropped() const noexcept { return this->dropped_; }
+
+private:
+	std::array<GameEvent, CAPACITY> events_;
+	std::size_t count_ = 0;
+	std::array<EventConsumer*, MAX_CONSUMERS> consumers_{};
+	std::size_t consumerCount_ = 0;
+	std::size_t dropped_ = 0;
+};
+
+
+// Telemetry: how often each event happened
+class EventCounter : public EventConsumer {
+public:
+	void consume(const GameEvent *events, std::size_t count) override;
+
+	std::uint64_t count(EventType type) const noexcept { return this->counts_[static_cast<std::size_t>(type)]; }
+	void reset() noexcept { this->counts_.fill(0); }
+	void report(std::ostream &os) const;
+
+private:
+	std::array<std::uint64_t, static_cast<std::size_t>(EventType::Count)> counts_{};
+};
+
+#endif // !EVENTBUS_H
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+#include "fileWatcher.h"
+
+
+FileWatcher::FileWatcher(int intervalMs) : intervalMs_(intervalMs), thread_([this] { this->loop(); }) {}
+
+
+FileWatcher::~FileWatcher() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		this->stop_ = true;
+	}
+	this->wake_.notify_one();
+	this->thread_.join();
+}
+
+
+void FileWatcher::add(const std::string &path) {
+	std::lock_guard<std::mutex> lock(this->mutex_);
+	for (const File &f : this->files_)
+		if (f.path == path)
+			return;
+	File f{ path, -1, -1 };
+	stat(path, f.time, f.size);
+	this->files_.push_back(f);
+}
+
+
+std::vector<std::string> FileWatcher::changed() {
+	std::lock_guard<std::mutex> lock(this->mutex_);
+	std::vector<std::string> result;
+	result.swap(this->changed_);
+	return result;
+}
+
+
+bool FileWatcher::stat(const std::string &path, std::int64_t &time, std::int64_t &size) {
+	// Sub-second times: two saves of the same length within a second differ
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+		return false;
+	time = static_cast<std::int64_t>((static_cast<std::uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime);
+	size = static_cast<std::int64_t>((static_cast<std::uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow);
+#else
+	struct stat st;
+	if (::stat(path.c_str(), &st) != 0)
+		return false;
+#ifdef __APPLE__
+	const struct timespec &modified = st.st_mtimespec;
+#else
+	const struct timespec &modified = st.st_mtim;
+#endif
+	time = static_cast<std::int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+	size = static_cast<std::int64_t>(st.st_size);
+#endif
+	return true;
+}
+
+
+void FileWatcher::loop() {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	while (!this->stop_) {
+		this->wake_.wait_for(lock, std::chrono::milliseconds(this->intervalMs_));
+		if (this->stop_)
+			break;
+
+		// Stat without the lock, so add() and changed() never wait on the disk
+		std::vector<File> files = this->files_;
+		lock.unlock();
+		std::vector<std::string> changed;
+		for (File &f : files) {
+			std::int64_t time, size;
+			if (stat(f.path, time, size) && (time != f.time || size != f.size)) {
+				f.time = time;
+				f.size = size;
+				changed.push_back(f.path);
+			}
+		}
+		lock.lock();
+
+		for (File &f : files) {
+			auto it = std::find_if(this->files_.begin(), this->files_.end(), [&f](const File &g) { return g.path == f.path; });
+			if (it != this->files_.end()) {
+				it->time = f.time;
+				it->size = f.size;
+			}
+		}
+		for (auto &path : changed)
+			if (std::find(this->changed_.begin(), this->changed_.end(), path) == this->changed_.end())
+				this->changed_.push_back(path);
+	}
+}
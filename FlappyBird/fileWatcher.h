@@ -0,0 +1,54 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/*
+\  Polls the modification time (finer than a second) and size of a few files
+\  on its own thread and collects the ones that changed. Polling works the
+\  same on every platform and costs one stat per file and interval, which is
+\  nothing for a handful of shader sources.
+*/
+class FileWatcher {
+public:
+	explicit FileWatcher(int intervalMs = 250);
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher &) = delete;
+	FileWatcher(FileWatcher &&) = delete;
+	FileWatcher& operator=(const FileWatcher &) = delete;
+	FileWatcher& operator=(FileWatcher &&) = delete;
+
+	// Start watching; adding a watched path again does nothing
+	void add(const std::string &path);
+
+	// Paths changed since the last call, each once
+	std::vector<std::string> changed();
+
+private:
+	struct File {
+		std::string path;
+		std::int64_t time;            // in the platform's file time unit
+		std::int64_t size;
+	};
+
+	// False when the file cannot be stat'ed (e.g. mid-save)
+	static bool stat(const std::string &path, std::int64_t &time, std::int64_t &size);
+	void loop();
+
+	int intervalMs_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	bool stop_ = false;
+	std::vector<File> files_;
+	std::vector<std::string> changed_;
+	std::thread thread_;               // declared last, starts after the rest
+};
+
+#endif // !FILEWATCHER_H
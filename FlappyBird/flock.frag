@@ -0,0 +1,16 @@
+#version 430 core
+
+in vec2 TexCoord;
+
+out vec4 color;
+
+uniform sampler2D birdTex;
+uniform float alpha;
+
+void main()
+{
+	vec4 texColor = texture(birdTex, TexCoord);
+	if(texColor.a < 0.1)
+        discard;
+	color = vec4(texColor.rgb, texColor.a * alpha);
+}
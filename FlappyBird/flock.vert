@@ -0,0 +1,18 @@
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texCoord;
+layout (location = 2) in vec2 instance; // <x, y>
+layout (location = 3) in vec4 uvRect;   // <u0, v0, u1, v1> of the frame in the atlas, v0 at the top
+
+uniform mat4 projection;
+uniform vec2 scale;
+uniform float z;
+
+out vec2 TexCoord;
+
+void main()
+{
+	gl_Position = projection * vec4(position.xy * scale + instance.xy, z, 1.0f);
+	TexCoord = vec2(mix(uvRect.x, uvRect.z, texCoord.x), mix(uvRect.y, uvRect.w, 1.0f - texCoord.y));
+}
@@ -0,0 +1,190 @@
+#ifndef FLOCKRENDERER_H
+#define FLOCKRENDERER_H
+
+#include <vector>
+#include <iostream>
+#include "GL\glew.h"
+#include "textureCache.h"
+#include "glm\glm.hpp"
+#include "glm\gtc\type_ptr.hpp"
+#include "drawAble.h"
+#include "shader.h"
+#include "config.h"
+#include "board.h"
+#include "birdFlock.h"
+#include "frameRing.h"
+#include "spriteAnimation.h"
+
+
+/*
+\  Draws every alive bird of a BirdFlock with one instanced draw call.
+\  All skins live in one atlas, a row of FrameCount cells per skin; every
+\  instance carries the UV rect of its current frame, so birds in any
+\  state of their animation share the one draw and the one texture.
+\  Instances are written straight into the frame's part of a FrameRing.
+*/
+class FlockRenderer : public DrawAble {
+public:
+	FlockRenderer(TextureCache &textures, FrameRing &ring, const std::vector<std::vector<const char*>> &skins,
+		const glm::vec3 scale = { 0.6f, 0.6f, 1.0f }, const GLfloat alpha = 0.4f)
+		: ring_(ring), scale_(scale), alpha_(alpha), count_(0), sheet_(BirdFlock::FrameCount, 1, 0, 0)
+	{
+		// Bird frames all share one size, take it from the first
+		GLint textureWidth = 0, textureHeight = 0;
+		if (!skins.empty() && !skins[0].empty()) {
+			glBindTexture(GL_TEXTURE_2D, textures.get(skins[0][0]));
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &textureWidth);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &textureHeight);
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+		this->sheet_ = SpriteSheet(BirdFlock::FrameCount, static_cast<int>(skins.size()), textureWidth, textureHeight);
+
+		// Gutters stay transparent
+		std::vector<unsigned char> clear(4 * this->sheet_.width() * this->sheet_.height(), 0);
+		glGenTextures(1, &this->texture_);
+		glBindTexture(GL_TEXTURE_2D, this->texture_);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, this->sheet_.width(), this->sheet_.height(),
+			0, GL_RGBA, GL_UNSIGNED_BYTE, clear.data());
+		// Birds are only ever magnified, and mipmaps would blend neighbouring cells
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// Cells are copied on the GPU from the bird textures in the cache,
+		// so no image is decoded twice
+		for (std::size_t row = 0; row < skins.size(); ++row) {
+			for (std::size_t column = 0; column < skins[row].size() && column < BirdFlock::FrameCount; ++column) {
+				GLuint source = textures.get(skins[row][column]);
+				GLint width = 0, height = 0;
+				glBindTexture(GL_TEXTURE_2D, source);
+				glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+				glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+				glBindTexture(GL_TEXTURE_2D, 0);
+				if (width != textureWidth || height != textureHeight) {
+					std::cerr << "ERROR: in " << __FILE__
+						<< " line " << __LINE__
+						<< ": " << skins[row][column] << " is not " << textureWidth << "x" << textureHeight << ", left out of the atlas" << std::endl;
+					continue;
+				}
+
+				int cell = static_cast<int>(row * BirdFlock::FrameCount + column);
+				glCopyImageSubData(source, GL_TEXTURE_2D, 0, 0, 0, 0,
+					this->texture_, GL_TEXTURE_2D, 0, this->sheet_.x(cell), this->sheet_.y(cell), 0,
+					textureWidth, textureHeight, 1);
+			}
+		}
+
+		glGenVertexArrays(1, &this->VAO_);
+		glBindVertexArray(this->VAO_);
+
+		GLuint VBO;
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		auto vertices = BoardSp::getVertices();
+		glBufferData(GL_ARRAY_BUFFER, BoardSp::SIZE * sizeof(GLfloat), vertices.get(), GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), reinterpret_cast<GLvoid*>(0));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), reinterpret_cast<GLvoid*>(3 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(1);
+
+		// Instances <vec2 position, vec4 uv rect> come from binding INSTANCES,
+		// pointed at the ring each frame
+		glVertexAttribFormat(2, 2, GL_FLOAT, GL_FALSE, 0);
+		glVertexAttribBinding(2, INSTANCES);
+		glEnableVertexAttribArray(2);
+		glVertexAttribFormat(3, 4, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat));
+		glVertexAttribBinding(3, INSTANCES);
+		glEnableVertexAttribArray(3);
+		glVertexBindingDivisor(INSTANCES, 1);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	FlockRenderer(const FlockRenderer &) = delete;
+	FlockRenderer &operator=(const FlockRenderer &) = delete;
+
+	~FlockRenderer() {
+		glDeleteVertexArrays(1, &this->VAO_);
+		glDeleteTextures(1, &this->texture_);
+	}
+
+	// Write the instances of all alive birds, once per frame
+	void update(const BirdFlock &flock) {
+		this->count_ = 0;
+		FrameAllocation a = this->ring_.allocate<GLfloat>(INSTANCE_FLOATS * flock.size());
+		if (!a)
+			return;
+		this->count_ = flock.fillInstances(static_cast<GLfloat*>(a.data), this->sheet_);
+		this->ring_.commit(a);
+
+		glBindVertexArray(this->VAO_);
+		glBindVertexBuffer(INSTANCES, a.buffer, a.offset, INSTANCE_FLOATS * sizeof(GLfloat));
+		glBindVertexArray(0);
+	}
+
+	void draw(Shader &shader) override {
+		if (!this->count_)
+			return;
+
+		shader.use();
+
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "projection"),
+			1, GL_FALSE, glm::value_ptr(PROJECTION));
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, this->texture_);
+		glUniform1i(glGetUniformLocation(shader.getProgram(), "birdTex"), 0);
+
+		// Ghosts are translucent, draw them after the player bird
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		this->issue(shader, RenderCommand());
+		glBindVertexArray(0);
+		glDisable(GL_BLEND);
+	}
+
+	// Ghosts are translucent: the blended pass, after every opaque draw
+	void submit(RenderQueue &queue, Shader &shader, float z) override {
+		if (!this->count_)
+			return;
+		RenderCommand command;
+		command.pass = RenderPass::Blended;
+		command.shader = &shader;
+		command.program = shader.getProgram();
+		command.target = GL_TEXTURE_2D;
+		command.texture = this->texture_;
+		command.z = z;
+		command.source = this;
+		queue.push(command);
+	}
+
+	void issue(Shader &shader, const RenderCommand &command) override {
+		glUniform2f(glGetUniformLocation(shader.getProgram(), "scale"), this->scale_.x, this->scale_.y);
+		glUniform1f(glGetUniformLocation(shader.getProgram(), "alpha"), this->alpha_);
+		glUniform1f(glGetUniformLocation(shader.getProgram(), "z"), command.z);
+
+		glBindVertexArray(this->VAO_);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, BoardSp::SIZE / 5, static_cast<GLsizei>(this->count_));
+	}
+
+private:
+	// Vertex buffer binding of the instance attribute; 0 and 1 belong to the quad
+	static constexpr GLuint INSTANCES = 2;
+	static constexpr GLuint INSTANCE_FLOATS = 6;
+
+	FrameRing &ring_;
+	glm::vec3 scale_;
+	GLfloat alpha_;
+	GLuint VAO_;
+	GLuint texture_;
+	std::size_t count_;
+	SpriteSheet sheet_;
+};
+
+constexpr GLuint FlockRenderer::INSTANCES;
+constexpr GLuint FlockRenderer::INSTANCE_FLOATS;
+
+#endif // !FLOCKRENDERER_H
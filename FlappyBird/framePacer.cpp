@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "framePacer.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#pragma comment(lib, "Winmm.lib")
+#endif
+
+
+constexpr std::size_t FramePacer::HISTORY;
+
+
+namespace {
+	FramePacer::clock::duration toDuration(double ms) {
+		return std::chrono::duration_cast<FramePacer::clock::duration>(std::chrono::duration<double, std::milli>(ms));
+	}
+}
+
+
+FramePacer::FramePacer(double targetMs, double spinMs) : targetMs_(targetMs), spin_(toDuration(spinMs)) {
+#ifdef _WIN32
+	// 1 ms scheduler ticks instead of 15.6 ms, or every sleep overshoots a frame
+	timeBeginPeriod(1);
+#endif
+}
+
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+
+void FramePacer::wait() {
+	clock::time_point now = clock::now();
+	if (this->restart_) {
+		this->restart_ = false;
+		this->next_ = now;
+		this->last_ = now;
+		return;
+	}
+
+	if (this->targetMs_ > 0.0) {
+		clock::duration period = toDuration(this->targetMs_);
+		this->next_ += period;
+		if (this->next_ + period < now)
+			this->next_ = now;     // far behind: start over from here
+
+		if (this->next_ - now > this->spin_)
+			std::this_thread::sleep_until(this->next_ - this->spin_);
+		while ((now = clock::now()) < this->next_)
+			std::this_thread::yield();
+	}
+
+	this->intervals_[this->count_ % HISTORY] = std::chrono::duration<float, std::milli>(now - this->last_).count();
+	++this->count_;
+	this->last_ = now;
+}
+
+
+FrameStats FramePacer::stats() const {
+	FrameStats s;
+	s.frames = std::min(this->count_, HISTORY);
+	if (s.frames == 0)
+		return s;
+
+	std::vector<float> sorted(this->intervals_.begin(), this->intervals_.begin() + s.frames);
+	std::sort(sorted.begin(), sorted.end());
+	double sum = 0.0, squares = 0.0;
+	for (float ms : sorted) {
+		sum += ms;
+		squares += static_cast<double>(ms) * ms;
+		if (this->targetMs_ > 0.0 && ms > 1.5 * this->targetMs_)
+			++s.late;
+	}
+	s.meanMs = sum / s.frames;
+	s.jitterMs = std::sqrt(std::max(0.0, squares / s.frames - s.meanMs * s.meanMs));
+	s.minMs = sorted.front();
+	s.maxMs = sorted.back();
+	s.p99Ms = sorted[std::min(s.frames - 1, s.frames * 99 / 100)];
+	return s;
+}
+
+
+void FramePacer::report(std::ostream &os) const {
+	FrameStats s = this->stats();
+	os << "frames " << s.frames << ", mean " << s.meanMs << " ms, jitter " << s.jitterMs << " ms, min " << s.minMs
+		<< ", p99 " << s.p99Ms << ", max " << s.maxMs << ", late " << s.late;
+	if (this->targetMs_ > 0.0)
+		os << " (target " << this->targetMs_ << " ms)";
+	os << std::endl;
+}
+
+
+void FramePacer::clearStats() noexcept {
+	this->count_ = 0;
+}
@@ -0,0 +1,72 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+
+// Frame-to-frame intervals over the recent window
+struct FrameStats {
+	std::size_t frames = 0;
+	double meanMs = 0.0;
+	double jitterMs = 0.0;      // standard deviation of the interval
+	double minMs = 0.0;
+	double maxMs = 0.0;
+	double p99Ms = 0.0;
+	std::size_t late = 0;       // intervals over 1.5x the target
+};
+
+
+/*
+\  Holds frames to a target interval. OS sleeps overshoot by up to a
+\  scheduler tick, so wait() sleeps until spinMs before the deadline and
+\  spins (yielding) for the rest. Deadlines advance by exactly one target
+\  interval, so an early or late frame does not shift the ones after it;
+\  a frame more than one interval late restarts the schedule instead of
+\  racing to catch up.
+\
+\  Every interval between frames is recorded for FrameStats. Call
+\  restart() after a deliberate pause (an idle screen) so the gap is not
+\  counted as a stutter.
+*/
+class FramePacer {
+public:
+	using clock = std::chrono::steady_clock;
+	static constexpr std::size_t HISTORY = 600;
+
+	// targetMs 0 only records intervals (vsync or no cap paces the frames)
+	explicit FramePacer(double targetMs = 0.0, double spinMs = 1.5);
+	~FramePacer();
+
+	FramePacer(const FramePacer &) = delete;
+	FramePacer(FramePacer &&) = delete;
+	FramePacer& operator=(const FramePacer &) = delete;
+	FramePacer& operator=(FramePacer &&) = delete;
+
+	void setTarget(double targetMs) noexcept { this->targetMs_ = targetMs; }
+	double target() const noexcept { return this->targetMs_; }
+
+	// End of a frame: wait for its deadline, then record the interval
+	void wait();
+	// Forget the previous frame time and deadline
+	void restart() noexcept { this->restart_ = true; }
+
+	FrameStats stats() const;
+	void report(std::ostream &os) const;
+	void clearStats() noexcept;
+
+private:
+	double targetMs_;
+	clock::duration spin_;
+	clock::time_point next_;
+	clock::time_point last_;
+	bool restart_ = true;
+
+	std::array<float, HISTORY> intervals_{};    // ms, ring
+	std::size_t count_ = 0;                      // recorded, may exceed HISTORY
+};
+
+#endif // !FRAMEPACER_H
@@ -0,0 +1,172 @@
+#ifndef FRAMERING_H
+#define FRAMERING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "GL\glew.h"
+
+
+// Part of the ring handed out for one frame; write through data, then commit()
+struct FrameAllocation {
+	void *data = nullptr;
+	GLuint buffer = 0;
+	GLintptr offset = 0;
+	GLsizeiptr size = 0;
+
+	explicit operator bool() const noexcept { return this->data != nullptr; }
+};
+
+
+/*
+\  Per-frame dynamic GPU data (vertices, instances, uniform blocks) from one
+\  buffer that stays mapped for the life of the program
+\  (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT). It is split into FRAMES
+\  regions used in turn; beginFrame() waits for the fence of the frame that
+\  last used the region, so the CPU never writes what the GPU still reads,
+\  and endFrame() fences it again. Allocating is a pointer bump, and no
+\  buffer is orphaned or copied by the driver.
+\
+\  Without GL_ARB_buffer_storage the same interface writes into a CPU
+\  copy and commit() uploads each allocation with glBufferSubData.
+\  A frame that asks for more than its region gets empty allocations
+\  (counted in overflows()); callers skip that data for the frame.
+*/
+class FrameRing {
+public:
+	static constexpr int FRAMES = 3;
+
+	explicit FrameRing(GLsizeiptr frameSize = 1 << 20) : frameSize_(frameSize) {}
+
+	FrameRing(const FrameRing &) = delete;
+	FrameRing(FrameRing &&) = delete;
+	FrameRing &operator=(const FrameRing &) = delete;
+	FrameRing &operator=(FrameRing &&) = delete;
+
+	~FrameRing() {
+		for (GLsync &fence : this->fences_)
+			if (fence)
+				glDeleteSync(fence);
+		if (this->buffer_) {
+			if (this->mapped_) {
+				glBindBuffer(GL_ARRAY_BUFFER, this->buffer_);
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+			}
+			glDeleteBuffers(1, &this->buffer_);
+		}
+	}
+
+	// Start of a frame, before any allocate()
+	void beginFrame() {
+		if (!this->buffer_)
+			this->create();
+
+		this->frame_ = (this->frame_ + 1) % FRAMES;
+		GLsync &fence = this->fences_[this->frame_];
+		if (fence) {
+			// Normally signalled long ago; otherwise the GPU is FRAMES frames behind
+			GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+			if (result == GL_TIMEOUT_EXPIRED) {
+				++this->stalls_;
+				do {
+					result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);   // 1 ms
+				} while (result == GL_TIMEOUT_EXPIRED);
+			}
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+		this->used_ = 0;
+	}
+
+	// size bytes, aligned to alignment (a power of two) from the start of the buffer
+	FrameAllocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16) {
+		GLintptr start = (this->used_ + alignment - 1) & ~(alignment - 1);
+		if (!this->buffer_ || size <= 0 || start + size > this->frameSize_) {
+			if (size > 0)
+				++this->overflows_;
+			return FrameAllocation();
+		}
+		this->used_ = start + size;
+
+		FrameAllocation a;
+		a.buffer = this->buffer_;
+		a.offset = this->frame_ * this->frameSize_ + start;
+		a.size = size;
+		a.data = this->base() + a.offset;
+		return a;
+	}
+
+	// Typed helper: count elements of T
+	template <typename T>
+	FrameAllocation allocate(std::size_t count) {
+		return this->allocate(static_cast<GLsizeiptr>(count * sizeof(T)), static_cast<GLsizeiptr>(alignof(T) < 16 ? 16 : alignof(T)));
+	}
+
+	// Writes to a are done; only the fallback path has anything to do
+	void commit(const FrameAllocation &a) {
+		if (this->mapped_ || !a)
+			return;
+		glBindBuffer(GL_ARRAY_BUFFER, this->buffer_);
+		glBufferSubData(GL_ARRAY_BUFFER, a.offset, a.size, a.data);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	// After the frame's last draw that reads the ring
+	void endFrame() {
+		if (this->buffer_)
+			this->fences_[this->frame_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	bool persistent() const noexcept { return this->mapped_ != nullptr; }
+	GLsizeiptr frameSize() const noexcept { return this->frameSize_; }
+	// Frames that had to wait for the GPU, and allocations that did not fit
+	std::size_t stalls() const noexcept { return this->stalls_; }
+	std::size_t overflows() const noexcept { return this->overflows_; }
+
+private:
+	void create() {
+		GLsizeiptr total = FRAMES * this->frameSize_;
+		glGenBuffers(1, &this->buffer_);
+		glBindBuffer(GL_ARRAY_BUFFER, this->buffer_);
+		if (GLEW_ARB_buffer_storage) {
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_ARRAY_BUFFER, total, nullptr, flags);
+			this->mapped_ = static_cast<std::uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags));
+		}
+		if (!this->mapped_) {
+			std::cerr << "ERROR: in " << __FILE__
+				<< " line " << __LINE__
+				<< ": no persistent mapping, dynamic data is uploaded with glBufferSubData" << std::endl;
+			if (!GLEW_ARB_buffer_storage)
+				glBufferData(GL_ARRAY_BUFFER, total, nullptr, GL_STREAM_DRAW);
+			else {
+				// Immutable storage cannot be respecified; start over with a plain buffer
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+				glDeleteBuffers(1, &this->buffer_);
+				glGenBuffers(1, &this->buffer_);
+				glBindBuffer(GL_ARRAY_BUFFER, this->buffer_);
+				glBufferData(GL_ARRAY_BUFFER, total, nullptr, GL_STREAM_DRAW);
+			}
+			this->shadow_.resize(static_cast<std::size_t>(total));
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	std::uint8_t *base() noexcept { return this->mapped_ ? this->mapped_ : this->shadow_.data(); }
+
+	GLsizeiptr frameSize_;
+	GLuint buffer_ = 0;
+	std::uint8_t *mapped_ = nullptr;
+	std::vector<std::uint8_t> shadow_;     // fallback only
+	GLsync fences_[FRAMES] = {};
+	int frame_ = FRAMES - 1;
+	GLintptr used_ = 0;
+	std::size_t stalls_ = 0;
+	std::size_t overflows_ = 0;
+};
+
+constexpr int FrameRing::FRAMES;
+
+#endif // !FRAMERING_H
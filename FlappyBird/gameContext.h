@@ -0,0 +1,157 @@
+#ifndef GAMECONTEXT_H
+#define GAMECONTEXT_H
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include "gameSim.h"
+#include "eventBus.h"
+#include "inputQueue.h"
+
+
+enum modeSet {Easy = 0, Normal = 1, Hard = 2};
+enum skinSet {Origin = 0, Blue = 1};
+
+
+/*
+\  One game world: its GameSim (bird, course, ghosts, score, collision),
+\  the player's input and the game state. It has no GL objects; a GameView
+\  draws it, so many worlds can live in one process, shown or not.
+\
+\  update() does not play sounds or spawn effects itself: the simulation
+\  pushes what happened onto events, and the owner calls events.dispatch()
+\  once the frame's input and step are done. Audio (SharedResources),
+\  telemetry, the context itself and its views then each take the batch in turn.
+*/
+struct GameContext : EventConsumer {
+	static constexpr std::size_t ghostNum = 10000;
+	static constexpr unsigned GHOST_SEED = 0x9E3779B9u;     // mixed into courseSeed for the ghosts
+
+	// Fixed simulation step: 240 ticks a second keeps a flap within ~4 ms of its key press
+	static constexpr int TICK_RATE = 240;
+	static constexpr double TICK_MS = 1000.0 / TICK_RATE;
+	static constexpr double MAX_CATCH_UP_MS = 250.0;
+
+	// audio: takes every batch of events first
+	explicit GameContext(EventConsumer &audio) {
+		events.subscribe(audio);
+		events.subscribe(telemetry);
+		events.subscribe(*this);
+	}
+
+	GameContext(const GameContext &) = delete;
+	GameContext &operator=(const GameContext &) = delete;
+
+	// 重置游戏
+	void reset() {
+		GameConfig config;
+		config.mode = mode;
+		config.seed = courseSeed;
+		config.tubeNum = std::numeric_limits<std::size_t>::max();    // endless
+		config.tickRate = TICK_RATE;
+		// 幽灵鸟竞速: the ghosts' biases follow the course seed, so a seed replays the same race
+		config.ghosts = isGhostRace ? ghostNum : 0;
+		config.ghostSeed = courseSeed ^ GHOST_SEED;
+		sim.reset(config);
+		for (std::size_t i = 0; i < sim.ghosts().size(); ++i)
+			sim.ghosts().setSkin(i, i % 2);
+
+		simMs = -1.0;
+		isSpaceDown = false;
+		input.clear();
+	}
+
+	// Run every tick up to nowMs (InputQueue::nowMs() clock), each with the
+	// input that happened during it
+	void update(double nowMs) {
+		// 暂停时不改变鸟的绘制状态
+		if (isPaused)
+			return;
+
+		// Start, resume or a long stall: begin at the present instead of replaying the gap
+		if (simMs < 0.0 || nowMs - simMs > MAX_CATCH_UP_MS) {
+			simMs = nowMs - TICK_MS;
+			syncMs = simMs;
+
+			// Input of the skipped time is not played either, only whether space is held
+			InputEvent e;
+			while (input.popBefore(simMs, e))
+				isSpaceDown = e.type == InputEvent::Press;
+		}
+
+		while (simMs + TICK_MS <= nowMs && !sim.over()) {
+			simMs += TICK_MS;
+
+			// A press and release inside one tick still flaps once
+			bool pressed = false;
+			InputEvent e;
+			while (input.popBefore(simMs, e)) {
+				if (e.type == InputEvent::Press) {
+					if (!isSpaceDown && latency && e.timeMs >= syncMs)
+						latency->applied(e.timeMs);
+					pressed = pressed || !isSpaceDown;
+					isSpaceDown = true;
+				}
+				else
+					isSpaceDown = false;
+			}
+			// Holding the key keeps the bird flying
+			sim.step(pressed, &events, isSpaceDown);
+		}
+	}
+
+	// How far the world has scrolled since reset(), in world units
+	double scrolled() const noexcept {
+		return -static_cast<double>(GameRules::TUBE_SPEED) * sim.tickTime() * sim.tick();
+	}
+
+	// Telemetry of the frame's events
+	void consume(const GameEvent *batch, std::size_t count) override {
+		for (std::size_t i = 0; i < count; ++i) {
+			const GameEvent &e = batch[i];
+			if (e.type == EventType::Die && log) {
+				*log << "game over at tick " << e.tick << ", score " << e.value << ": ";
+				telemetry.report(*log);
+			}
+		}
+	}
+
+	void pause() {
+		isPaused = true;
+	}
+
+	void resume() {
+		isPaused = false;
+		simMs = -1.0;     // the paused time is not simulated, nor its input
+		input.clear();
+		isSpaceDown = false;
+	}
+
+	bool isPaused = false;
+	bool isSpaceDown = false;
+	bool isGhostRace = false;
+
+	int mode = Normal;
+	int skin = Origin;
+	unsigned courseSeed = 0;  // of the next reset(); the menu picks a new one per game
+
+	GameSim sim;
+
+	EventBus events;
+	EventCounter telemetry;    // since the program started
+
+	InputQueue input;          // flap key presses and releases, filled by the window callbacks
+	std::unique_ptr<LatencyMeter> latency;    // set to measure input latency
+	std::ostream *log = nullptr;              // set to report every game over
+	double simMs = -1.0;       // time simulated up to, < 0 before the first update
+	double syncMs = 0.0;       // when simMs last jumped; older input is not measured
+};
+
+constexpr std::size_t GameContext::ghostNum;
+constexpr unsigned GameContext::GHOST_SEED;
+constexpr int GameContext::TICK_RATE;
+constexpr double GameContext::TICK_MS;
+constexpr double GameContext::MAX_CATCH_UP_MS;
+
+#endif // !GAMECONTEXT_H
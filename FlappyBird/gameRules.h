@@ -0,0 +1,31 @@
+#ifndef GAMERULES_H
+#define GAMERULES_H
+
+
+/*
+\  Sizes and speeds of the game, shared by the simulation (GameSim) and the
+\  objects that draw it (Bird, Tube), so the two cannot drift apart.
+\  Lengths are world units, speeds per display()'s time unit (0.0001 * ms).
+*/
+namespace GameRules {
+	constexpr float BIRD_X = 0.0f;
+	constexpr float BIRD_START_Y = -109.693f;
+	constexpr float BIRD_START_VELOCITY = -1000.0f;
+	// Collision box of the bird, BoardSp::HALFEDGE * 0.6 - 5: its picture less the transparent rim
+	constexpr float BIRD_HALFEDGE = 25.0f;
+	// The bird is lost at or below this height
+	constexpr float OUT_Y = -500.0f;
+
+	constexpr float TUBE_HALFWIDTH = 50.0f;
+	constexpr float TUBE_HEIGHT = 800.0f;
+	// Scrolling of the tubes, to the left
+	constexpr float TUBE_SPEED = -2500.0f;
+
+	// Ticks per second of the hosted and headless games; each runner may pick its own
+	constexpr int TICK_RATE = 60;
+
+	// Length of one tick at rate ticks per second, in the time unit above
+	constexpr float tickTime(int rate) { return 0.0001f * 1000.0f / rate; }
+}
+
+#endif // !GAMERULES_H
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include "gameRunner.h"
+#include "gameSim.h"
+
+
+namespace {
+	// One chunk's result on its own cache line, so the workers writing
+	// neighbouring slots do not share one
+	struct alignas(64) ChunkResult {
+		RunResult r;
+	};
+}
+
+
+RunResult GameRunner::run(JobSystem &jobs) const {
+	std::size_t chunks = (this->games_ + this->chunk_ - 1) / this->chunk_;
+	std::vector<ChunkResult> partial(chunks);
+	RunResult total;
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<JobSystem::JobId> deps;
+	deps.reserve(chunks);
+	for (std::size_t c = 0; c < chunks; ++c) {
+		deps.push_back(jobs.add([this, c, &partial] {
+			RunResult &r = partial[c].r;
+			std::size_t first = c * this->chunk_;
+			std::size_t last = std::min(first + this->chunk_, this->games_);
+
+			GameConfig config;
+			GameSim game(config);
+			for (std::size_t g = first; g < last; ++g) {
+				config.seed = this->seed_ + static_cast<unsigned>(g);
+				game.reset(config);
+
+				// Every game gets its own autopilot bias
+				std::default_random_engine e(config.seed);
+				float bias = std::uniform_real_distribution<float>(-60.0f, 20.0f)(e);
+				while (game.tick() < this->maxTicks_ && game.step(game.autoFlap(bias)))
+					;
+
+				++r.games;
+				r.ticks += game.tick();
+				r.totalScore += game.score();
+				r.bestScore = std::max(r.bestScore, game.score());
+			}
+		}));
+	}
+
+	jobs.add([&partial, &total] {
+		for (auto &chunk : partial) {
+			const RunResult &r = chunk.r;
+			total.games += r.games;
+			total.ticks += r.ticks;
+			total.totalScore += r.totalScore;
+			total.bestScore = std::max(total.bestScore, r.bestScore);
+		}
+	}, deps);
+
+	jobs.wait();
+
+	total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return total;
+}
+
+
+void GameRunner::reportScaling(std::ostream &os, std::size_t maxWorkers) const {
+	os << "headless games: " << this->games_ << ", max ticks: " << this->maxTicks_
+		<< ", hardware threads: " << std::thread::hardware_concurrency() << "\n";
+	// wait() runs jobs on the calling thread as well, so a row uses one thread more than its workers
+	os << std::setw(8) << "workers" << std::setw(8) << "threads" << std::setw(14) << "games/s" << std::setw(14) << "Mticks/s"
+		<< std::setw(10) << "speedup" << std::setw(12) << "efficiency" << "\n";
+
+	double base = 0.0;
+	for (std::size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+		JobSystem jobs(workers);
+		RunResult r = this->run(jobs);
+		double rate = r.games / r.seconds;
+		std::size_t threads = workers + 1;
+		if (workers == 1)
+			base = rate;
+
+		// Against the first row and per thread, that row's two included
+		os << std::setw(8) << workers << std::setw(8) << threads
+			<< std::setw(14) << std::fixed << std::setprecision(0) << rate
+			<< std::setw(14) << std::setprecision(2) << r.ticks / r.seconds / 1e6
+			<< std::setw(10) << rate / base
+			<< std::setw(12) << rate / base * 2.0 / threads << "\n";
+	}
+}
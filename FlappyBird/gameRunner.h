@@ -0,0 +1,43 @@
+#ifndef GAMERUNNER_H
+#define GAMERUNNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include "jobSystem.h"
+
+
+// Totals of one bulk run
+struct RunResult {
+	std::size_t games = 0;
+	std::uint64_t ticks = 0;
+	std::uint64_t totalScore = 0;
+	int bestScore = 0;
+	double seconds = 0.0;
+};
+
+
+/*
+\  Runs many independent headless games (GameSim) on a JobSystem.
+\  Games are split into chunks; every chunk job writes only its own result slot
+\  and one reduce job, depending on all chunks, sums them up.
+*/
+class GameRunner {
+public:
+	GameRunner(std::size_t games, std::size_t maxTicks = 20000, unsigned seed = 0, std::size_t chunk = 64)
+		: games_(games), maxTicks_(maxTicks), seed_(seed), chunk_(chunk ? chunk : 1) {}
+
+	RunResult run(JobSystem &jobs) const;
+
+	// Run the same workload with 1, 2, 4 ... maxWorkers workers and print games/s and speedup;
+	// each run also has the calling thread, which helps in JobSystem::wait()
+	void reportScaling(std::ostream &os, std::size_t maxWorkers = 64) const;
+
+private:
+	std::size_t games_;
+	std::size_t maxTicks_;
+	unsigned seed_;
+	std::size_t chunk_;
+};
+
+#endif // !GAMERUNNER_H
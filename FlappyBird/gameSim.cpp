@@ -0,0 +1,135 @@
+#include "gameSim.h"
+#include "physic.h"
+
+
+constexpr std::size_t GameSim::TUBES_AHEAD;
+constexpr std::size_t GameSim::TUBES_BEHIND;
+
+
+GameSim::GameSim(const GameConfig &config)
+	: ghosts_(0, GameRules::BIRD_X, GameRules::BIRD_START_Y, GameRules::BIRD_HALFEDGE)
+{
+	this->reset(config);
+}
+
+
+void GameSim::reset(const GameConfig &config) {
+	CourseParams params = CourseParams::forMode(config.mode, config.seed);
+	params.startY = GameRules::BIRD_START_Y;
+	params.speed = -GameRules::TUBE_SPEED;
+	params.birdHalfEdge = GameRules::BIRD_HALFEDGE;
+	params.tubeHalfWidth = GameRules::TUBE_HALFWIDTH;
+	this->course_.reset(params);
+	this->course_.ensure(TUBES_AHEAD);
+	this->tubeNum_ = config.tubeNum;
+	this->tickTime_ = GameRules::tickTime(config.tickRate);
+
+	this->scroll_ = 0.0f;
+	this->birdY_ = GameRules::BIRD_START_Y;
+	this->birdV_ = GameRules::BIRD_START_VELOCITY;
+	BirdFlock::animation().play(this->sprite_, BirdFlock::NormalClip);
+	this->ghosts_ = BirdFlock(config.ghosts, GameRules::BIRD_X, GameRules::BIRD_START_Y, GameRules::BIRD_HALFEDGE, config.ghostSeed);
+	this->currTube_ = 0;
+	this->tick_ = 0;
+	this->score_ = 0;
+	this->over_ = false;
+}
+
+
+GameSim::TubeState GameSim::tube(std::size_t i) const noexcept {
+	const CourseTube &t = this->course_[i];
+	return { t.x, t.yAt(this->tick_ * this->tickTime_), t.halfSpace };
+}
+
+
+std::uint8_t GameSim::birdFrame() const noexcept {
+	return BirdFlock::animation().cell(this->sprite_);
+}
+
+
+bool GameSim::step(bool flap, EventBus *events, bool held) {
+	if (this->over_)
+		return false;
+
+	++this->tick_;
+
+	if (flap || held) {
+		this->birdV_ = utility::Motion::vFlap;
+		BirdFlock::animation().play(this->sprite_, BirdFlock::FlyClip);
+		if (flap && events)
+			events->push(EventType::Flap, this->tick_);
+	}
+	this->birdY_ += utility::Motion::displacement(this->birdV_, this->tickTime_);
+	this->birdV_ = utility::Motion::velocity(this->birdV_, this->tickTime_);
+
+	// Animation only matters to viewers; the same clips as every other bird
+	BirdFlock::animation().update(this->sprite_, this->birdV_, this->tickTime_);
+
+	// From the tick count, so long games do not add up rounding errors
+	this->scroll_ = static_cast<float>(static_cast<double>(GameRules::TUBE_SPEED) * this->tickTime_ * this->tick_);
+
+	if (this->currTube_ < this->tubeNum_) {
+		// 幽灵鸟朝下一个管子的空隙飞
+		if (this->ghosts_.size()) {
+			this->ghosts_.autoFlap(this->tube(this->currTube_).y);
+			this->ghosts_.step(this->tickTime_);
+		}
+
+		bool out = this->birdY_ <= GameRules::OUT_Y;
+		bool hit = this->collide();
+		if (out || hit) {
+			this->over_ = true;
+			if (events) {
+				events->push(EventType::Hit, this->tick_, out ? 1 : 0);
+				events->push(EventType::Die, this->tick_, this->score_);
+			}
+			return false;
+		}
+
+		// Passed the current tube
+		if (GameRules::BIRD_X > this->course_[this->currTube_].x + this->scroll_) {
+			++this->score_;
+			++this->currTube_;
+			if (events)
+				events->push(EventType::Score, this->tick_, this->score_);
+
+			// O(1) amortized: a chunk now and then, the one behind dropped
+			this->course_.ensure(this->currTube_ + TUBES_AHEAD);
+			if (this->currTube_ > TUBES_BEHIND)
+				this->course_.release(this->currTube_ - TUBES_BEHIND);
+		}
+	}
+	return true;
+}
+
+
+bool GameSim::autoFlap(float bias) const noexcept {
+	if (this->birdV_ > 0.0f || this->currTube_ >= this->tubeNum_)
+		return false;
+	return this->birdY_ < this->tube(this->currTube_).y + bias;
+}
+
+
+bool GameSim::collide() {
+	// Current and previous tube, up and down box each
+	this->boxes_.clear();
+	std::size_t first = this->currTube_ > 0 ? this->currTube_ - 1 : 0;
+	for (std::size_t i = first; i <= this->currTube_; ++i) {
+		TubeState t = this->tube(i);
+		float x = t.x + this->scroll_;
+		this->boxes_.add(x - GameRules::TUBE_HALFWIDTH, x + GameRules::TUBE_HALFWIDTH,
+			t.y + t.halfSpace, t.y + t.halfSpace + GameRules::TUBE_HEIGHT);
+		this->boxes_.add(x - GameRules::TUBE_HALFWIDTH, x + GameRules::TUBE_HALFWIDTH,
+			t.y - t.halfSpace - GameRules::TUBE_HEIGHT, t.y - t.halfSpace);
+	}
+
+	if (this->ghosts_.size())
+		this->ghosts_.collide(this->boxes_);
+
+	std::uint64_t mask = 0;
+	return utility::CollideDetectBatch(
+		GameRules::BIRD_X - GameRules::BIRD_HALFEDGE, GameRules::BIRD_X + GameRules::BIRD_HALFEDGE,
+		this->birdY_ - GameRules::BIRD_HALFEDGE, this->birdY_ + GameRules::BIRD_HALFEDGE,
+		this->boxes_.minX(), this->boxes_.maxX(), this->boxes_.minY(), this->boxes_.maxY(),
+		this->boxes_.size(), &mask) > 0;
+}
@@ -0,0 +1,108 @@
+#ifndef GAMESIM_H
+#define GAMESIM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "birdFlock.h"
+#include "collisionBatch.h"
+#include "courseGenerator.h"
+#include "eventBus.h"
+#include "gameRules.h"
+#include "spriteAnimation.h"
+
+
+// Settings of one headless game
+struct GameConfig {
+	int mode = 1;                  // 0 easy, 1 normal, 2 hard (same as main.cpp)
+	unsigned seed = 0;             // tube layout seed
+	std::size_t tubeNum = 999;     // course length
+	int tickRate = GameRules::TICK_RATE;    // ticks per second
+	std::size_t ghosts = 0;        // autopilot birds racing the player
+	unsigned ghostSeed = 0;        // of the ghosts' steering
+};
+
+
+/*
+\  Simulation of one game with a fixed time step: bird, course, ghosts,
+\  score, collision and events. It owns all of its state: no GL, no sound
+\  and no shared collision world, so any number of games can run on any
+\  threads at the same time. The local game (GameContext) runs one and GameView draws
+\  it; the session host runs one per client.
+*/
+class GameSim {
+public:
+	// Tube position in course coordinates; screen x is x + scroll().
+	// y is where the gap is at the current tick, it may move.
+	struct TubeState {
+		float x;
+		float y;
+		float halfSpace;
+	};
+
+	explicit GameSim(const GameConfig &config = GameConfig());
+
+	GameSim(const GameSim &) = default;
+	GameSim(GameSim &&) = default;
+	GameSim& operator=(const GameSim &) = default;
+	GameSim& operator=(GameSim &&) = default;
+	~GameSim() = default;
+
+	void reset(const GameConfig &config);
+
+	// Advance one tick; returns false once the game is over.
+	// What happened is pushed onto events when given; headless runs pass none.
+	// held: the flap key is still down from an earlier tick, the bird keeps
+	// flying but that is no new Flap.
+	bool step(bool flap, EventBus *events = nullptr, bool held = false);
+
+	// Flap when falling below the next gap centre + bias (simple autopilot)
+	bool autoFlap(float bias = 0.0f) const noexcept;
+
+	bool over() const noexcept { return this->over_; }
+	int score() const noexcept { return this->score_; }
+	std::uint32_t tick() const noexcept { return this->tick_; }
+	// Tubes kept behind the current one, until they have scrolled off the screen
+	static constexpr std::size_t TUBES_BEHIND = 2;
+
+	// Length of a tick, in the time unit used by display() (0.0001 * ms)
+	float tickTime() const noexcept { return this->tickTime_; }
+	float birdY() const noexcept { return this->birdY_; }
+	float birdVelocity() const noexcept { return this->birdV_; }
+	std::uint8_t birdFrame() const noexcept;    // BirdFlock::Frame
+	float scroll() const noexcept { return this->scroll_; }
+	std::size_t currTube() const noexcept { return this->currTube_; }
+	// Tubes from tubeBegin() to tubeEnd() are there to read; the course is
+	// generated as the bird gets on, the few tubes ahead always exist
+	std::size_t tubeBegin() const noexcept { return this->currTube_ > TUBES_BEHIND ? this->currTube_ - TUBES_BEHIND : 0; }
+	std::size_t tubeEnd() const noexcept { return std::min(this->course_.end(), this->tubeNum_); }
+	TubeState tube(std::size_t i) const noexcept;
+
+	const BirdFlock &ghosts() const noexcept { return this->ghosts_; }
+	// Skins may be set; the rest is stepped with the game
+	BirdFlock &ghosts() noexcept { return this->ghosts_; }
+
+private:
+	// Kills the ghosts in the tubes around the bird; returns whether the bird hit one
+	bool collide();
+
+	// Tubes generated beyond the current one, enough to fill the screen
+	static constexpr std::size_t TUBES_AHEAD = 4;
+
+	CourseGenerator course_;
+	std::size_t tubeNum_;
+	float tickTime_;
+	utility::BoxBatch boxes_;
+	float scroll_;
+	float birdY_;
+	float birdV_;
+	SpritePlayer sprite_;
+	BirdFlock ghosts_;
+	std::size_t currTube_;
+	std::uint32_t tick_;
+	int score_;
+	bool over_;
+};
+
+#endif // !GAMESIM_H
@@ -0,0 +1,224 @@
+#ifndef GAMEVIEW_H
+#define GAMEVIEW_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "GL\glew.h"
+#include "glm\glm.hpp"
+#include "shader.h"
+#include "textureCache.h"
+#include "shaderCache.h"
+#include "frameRing.h"
+#include "assetLoader.h"
+#include "bird.h"
+#include "tube.h"
+#include "particle_generator.h"
+#include "SoundManager.h"
+#include "scoreBoard.h"
+#include "flockRenderer.h"
+#include "gameContext.h"
+
+
+// Resources shared by every game view of the process.
+// Also the audio consumer of every world's events.
+struct SharedResources : EventConsumer {
+	TextureCache textures;
+	ShaderCache shaders;
+	AssetPack pack;                        // closed when there is no pack, then loose files are used
+	FrameRing frames;                      // per-frame instance data, advanced by display()
+	std::unique_ptr<SoundManager> sound;   // null when running without audio
+
+	std::size_t wingSound = 0;
+	std::size_t pointSound = 0;
+	std::size_t dieSound = 0;
+	std::size_t hitSound = 0;
+	std::size_t clickSound = 0;
+
+	// Sound effect files, in the order of the ids above
+	static std::vector<const char*> soundPaths() {
+		return { "sounds//wing.wav", "sounds//point.wav", "sounds//die.wav", "sounds//hit.wav", "sounds//buttonClick.wav" };
+	}
+
+	// Every texture the game worlds use. Paths missing here still work,
+	// they are just decoded on the render thread on first use.
+	static std::vector<const char*> texturePaths() {
+		std::vector<const char*> paths(origin_tex);
+		paths.insert(paths.end(), blue_tex.begin(), blue_tex.end());
+		paths.insert(paths.end(), score_tex.begin(), score_tex.end());
+		paths.push_back("texture//tube.png");
+		paths.push_back("texture//particle.png");
+		return paths;
+	}
+
+	// Mixer settings of the sound effects, in soundPaths() order.
+	// Rapid flaps overlap instead of cutting each other off, and a crash always
+	// gets a voice.
+	static std::vector<SoundParams> soundParams() {
+		return {
+			{ 0, 3, 1.0f },     // wing
+			{ 1, 2, 1.0f },     // point
+			{ 2, 1, 1.0f },     // die
+			{ 2, 1, 1.0f },     // hit
+			{ 1, 2, 1.0f }      // click
+		};
+	}
+
+	// Queue the sound effects; the ids are set once the loader uploads them
+	void loadSounds(AssetLoader &loader) {
+		std::size_t *ids[] = { &wingSound, &pointSound, &dieSound, &hitSound, &clickSound };
+		auto paths = soundPaths();
+		auto params = soundParams();
+		for (std::size_t i = 0; i < paths.size(); ++i)
+			loader.sound(paths[i], *ids[i], params[i]);
+	}
+
+	void loadTextures(AssetLoader &loader) {
+		for (auto tex : texturePaths())
+			loader.texture(tex);
+	}
+
+	void play(std::size_t index) {
+		if (this->sound)
+			this->sound->play(index);
+	}
+
+	void consume(const GameEvent *events, std::size_t count) override {
+		if (!this->sound)
+			return;
+		for (std::size_t i = 0; i < count; ++i) {
+			switch (events[i].type) {
+			case EventType::Flap: this->play(wingSound); break;
+			case EventType::Score: this->play(pointSound); break;
+			case EventType::Hit: this->play(hitSound); break;
+			case EventType::Die: this->play(dieSound); break;
+			case EventType::ButtonClick: this->play(clickSound); break;
+			default: break;
+			}
+		}
+	}
+};
+
+
+/*
+\  Draws one GameContext: bird, tubes, score board, ghosts and particles,
+\  placed from its GameSim after every update. The world has no GL objects
+\  of its own, so it can be shown by any number of views, or by none.
+*/
+struct GameView : EventConsumer {
+	// Tubes drawn beyond the current one, enough to fill the screen
+	static constexpr std::size_t tubesAhead = 4;
+	static constexpr std::size_t particleNum = 500;
+	// Tube views: every tube the simulation keeps behind the bird, its current one and those ahead
+	static constexpr std::size_t tubeViews = GameSim::TUBES_BEHIND + 1 + tubesAhead;
+
+	GameView(SharedResources &res, GameContext &world)
+		: shared(res), game(world),
+		pScore(std::make_unique<ScoreBoard>(res.textures, res.frames, glm::vec3{ 0.0f, 400.0f, 0.0f }, glm::vec3{ 0.26f, 0.36f, 1.0f }, 0)),
+		particles(std::make_unique<ParticleGenerator>(res.textures, res.frames, particleNum)),
+		pGhostRenderer(std::make_unique<FlockRenderer>(res.textures, res.frames, std::vector<std::vector<const char*>>{ origin_tex, blue_tex })) {
+		// Made once: tubes coming into view reuse the ones gone by
+		for (std::size_t i = 0; i < tubeViews; ++i)
+			tubes.emplace_back(std::make_unique<Tube>(res.textures));
+		game.events.subscribe(*this);
+	}
+
+	GameView(const GameView &) = delete;
+	GameView &operator=(const GameView &) = delete;
+
+	// After game.reset(): the bird of its mode and skin, no tubes yet
+	void reset() {
+		pBird = std::make_unique<Bird>(shared.textures, glm::vec3{ GameRules::BIRD_X, GameRules::BIRD_START_Y, 0.0f }, game.mode, game.skin);
+		firstTube = 0;
+		tubeCount = 0;
+		frameMs = 0.0;
+		sync();
+	}
+
+	// After game.update(nowMs): follow the simulation, move the particles
+	void update(double nowMs) {
+		if (game.isPaused)
+			return;
+		sync();
+
+		// Not back past the game's last jump in time, as after a pause
+		frameMs = std::max(frameMs, game.syncMs);
+		GLfloat frameTime = static_cast<GLfloat>(0.0001 * (nowMs - frameMs));
+		frameMs = nowMs;
+		particles->update(frameTime, pBird->getPosition2f(), glm::vec2{ -GameRules::TUBE_SPEED, game.sim.birdVelocity() }, 2, glm::vec2(pBird->getHalfEdge()));
+	}
+
+	// 提交积分板，鸟，粒子和管子的绘制; the queue sorts them by state and depth
+	void submit(RenderQueue &queue, Shader &boardShader, Shader &flockShader, Shader &particleShader, Shader &tubeShader, Shader &textShader) {
+		if (game.isPaused)
+			pScore->setPause();
+		else
+			pScore->setRun();
+		pScore->submit(queue, textShader, RenderLayer::Ui);
+		pBird->submit(queue, boardShader, RenderLayer::Bird);
+
+		if (game.sim.ghosts().size()) {
+			pGhostRenderer->update(game.sim.ghosts());
+			pGhostRenderer->submit(queue, flockShader, RenderLayer::Effects);
+		}
+
+		// 绘制粒子效果
+		particles->submit(queue, particleShader, RenderLayer::Effects);
+
+		// 屏幕外的管子不画
+		for (std::size_t i = firstTube; i < firstTube + tubeCount; ++i)
+			if (tube(i).visible())
+				tube(i).submit(queue, tubeShader, RenderLayer::Tubes);
+	}
+
+	// Effects of the frame's events
+	void consume(const GameEvent *batch, std::size_t count) override {
+		for (std::size_t i = 0; i < count; ++i) {
+			const GameEvent &e = batch[i];
+			// Spawned with no time step, so they start at the bird this frame
+			if (e.type == EventType::Flap)
+				particles->update(0.0f, pBird->getPosition2f(), glm::vec2{ -GameRules::TUBE_SPEED, game.sim.birdVelocity() }, 6, glm::vec2(pBird->getHalfEdge()));
+			else if (e.type == EventType::Score)
+				particles->update(0.0f, pBird->getPosition2f(), glm::vec2{ -GameRules::TUBE_SPEED, 0.0f }, 20, glm::vec2(pBird->getHalfEdge()));
+		}
+	}
+
+	// View of course tube i, which must be one of the tubeCount from firstTube
+	Tube &tube(std::size_t i) { return *tubes[i % tubes.size()]; }
+
+	SharedResources &shared;
+	GameContext &game;
+
+	std::unique_ptr<Bird> pBird;
+	std::unique_ptr<ScoreBoard> pScore;
+	std::vector<std::unique_ptr<Tube>> tubes;  // ring of tubeViews, see tube()
+	std::size_t firstTube = 0;                 // course index of the first tube shown
+	std::size_t tubeCount = 0;
+	std::unique_ptr<ParticleGenerator> particles;
+	std::unique_ptr<FlockRenderer> pGhostRenderer;
+	double frameMs = 0.0;      // previous update, for the particles
+
+private:
+	// Bird, score and the tubes the simulation keeps, up to tubesAhead
+	// beyond the current one, each on its slot of the ring
+	void sync() {
+		const GameSim &sim = game.sim;
+		pBird->show(sim.birdY(), sim.birdFrame());
+		pScore->setValue(sim.score());
+
+		firstTube = sim.tubeBegin();
+		std::size_t end = std::min(sim.tubeEnd(), sim.currTube() + tubesAhead + 1);
+		tubeCount = end > firstTube ? end - firstTube : 0;
+		for (std::size_t i = firstTube; i < end; ++i) {
+			GameSim::TubeState t = sim.tube(i);
+			tube(i).show(t.x + sim.scroll(), t.y, t.halfSpace);
+		}
+	}
+};
+
+constexpr std::size_t GameView::tubesAhead;
+constexpr std::size_t GameView::particleNum;
+constexpr std::size_t GameView::tubeViews;
+
+#endif // !GAMEVIEW_H
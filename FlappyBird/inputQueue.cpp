@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <chrono>
+#include "inputQueue.h"
+
+
+constexpr std::size_t InputQueue::CAPACITY;
+
+
+double InputQueue::nowMs() noexcept {
+	static const auto start = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+bool InputQueue::push(const InputEvent &event) noexcept {
+	if (this->size() == CAPACITY) {
+		++this->dropped_;
+		return false;
+	}
+	this->events_[this->tail_++ % CAPACITY] = event;
+	return true;
+}
+
+
+bool InputQueue::popBefore(double timeMs, InputEvent &event) noexcept {
+	if (this->head_ == this->tail_ || this->events_[this->head_ % CAPACITY].timeMs >= timeMs)
+		return false;
+	event = this->events_[this->head_++ % CAPACITY];
+	return true;
+}
+
+
+void LatencyMeter::applied(double timeMs) {
+	this->pending_.push_back(timeMs);
+}
+
+
+void LatencyMeter::presented(double timeMs) {
+	for (double t : this->pending_)
+		this->samples_.push_back(static_cast<float>(timeMs - t));
+	this->pending_.clear();
+}
+
+
+void LatencyMeter::report(std::ostream &os, double refreshMs) const {
+	if (this->samples_.empty()) {
+		os << "no input samples" << std::endl;
+		return;
+	}
+	std::vector<float> sorted(this->samples_);
+	std::sort(sorted.begin(), sorted.end());
+	double sum = 0.0;
+	for (float ms : sorted)
+		sum += ms;
+	double mean = sum / sorted.size();
+	os << sorted.size() << " inputs to swap: mean " << mean << " ms, p50 " << sorted[sorted.size() / 2]
+		<< ", p99 " << sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)] << ", max " << sorted.back()
+		<< "; to photon ~" << mean + refreshMs / 2 << " ms" << std::endl;
+}
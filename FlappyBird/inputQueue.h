@@ -0,0 +1,74 @@
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+
+// A key going down or up, stamped when the window system delivered it
+struct InputEvent {
+	enum Type : std::uint8_t { Press, Release };
+
+	Type type;
+	unsigned char key;
+	double timeMs;      // InputQueue::nowMs() clock
+};
+
+
+/*
+\  Key events in arrival order, filled by the GLUT callbacks and drained by
+\  the fixed-step simulation, which applies each event at the tick covering
+\  its timestamp instead of sampling a "key is down" flag once per frame:
+\  a tap that starts and ends between two frames still flaps.
+\  Fixed capacity; when full new events are dropped and counted.
+*/
+class InputQueue {
+public:
+	static constexpr std::size_t CAPACITY = 256;
+
+	// Milliseconds on a steady clock, shared by input and frame timing
+	static double nowMs() noexcept;
+
+	bool push(InputEvent::Type type, unsigned char key) noexcept { return this->push({ type, key, nowMs() }); }
+	bool push(const InputEvent &event) noexcept;
+
+	// Oldest event if it happened before timeMs
+	bool popBefore(double timeMs, InputEvent &event) noexcept;
+
+	void clear() noexcept { this->head_ = this->tail_ = 0; }
+	std::size_t size() const noexcept { return this->tail_ - this->head_; }
+	std::size_t dropped() const noexcept { return this->dropped_; }
+
+private:
+	std::array<InputEvent, CAPACITY> events_;
+	std::size_t head_ = 0, tail_ = 0;
+	std::size_t dropped_ = 0;
+};
+
+
+/*
+\  Input-to-photon estimate: the time from an input event to the return of
+\  the buffer swap of the first frame showing its effect. The display
+\  still has to scan the frame out, on average half a refresh more, which
+\  report() adds as an estimate.
+*/
+class LatencyMeter {
+public:
+	// The simulation acted on an event stamped timeMs this frame
+	void applied(double timeMs);
+	// This frame's swap returned at timeMs
+	void presented(double timeMs);
+
+	std::size_t samples() const noexcept { return this->samples_.size(); }
+	void report(std::ostream &os, double refreshMs = 1000.0 / 60.0) const;
+	void clear() noexcept { this->samples_.clear(); }
+
+private:
+	std::vector<double> pending_;
+	std::vector<float> samples_;
+};
+
+#endif // !INPUTQUEUE_H
@@ -0,0 +1,173 @@
+#include <chrono>
+#include "jobSystem.h"
+
+
+namespace {
+	constexpr std::size_t NOT_WORKER = static_cast<std::size_t>(-1);
+
+	// Worker index of the current thread, valid when tlsOwner is the calling JobSystem
+	thread_local const JobSystem *tlsOwner = nullptr;
+	thread_local std::size_t tlsWorker = NOT_WORKER;
+}
+
+
+JobSystem::JobSystem(std::size_t workers)
+	: queued_(0), unfinished_(0), next_(0), quit_(false)
+{
+	if (workers == 0)
+		workers = std::thread::hardware_concurrency();
+	if (workers == 0)
+		workers = 1;
+
+	for (std::size_t i = 0; i < workers; ++i)
+		this->queues_.emplace_back(new WorkQueue());
+	for (std::size_t i = 0; i < workers; ++i)
+		this->threads_.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+
+JobSystem::~JobSystem() {
+	this->wait();
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex_);
+		this->quit_ = true;
+	}
+	this->wake_.notify_all();
+	for (auto &t : this->threads_)
+		t.join();
+}
+
+
+JobSystem::JobId JobSystem::add(std::function<void()> fn, const std::vector<JobId> &deps) {
+	Job *job;
+	JobId id;
+	{
+		std::lock_guard<std::mutex> lock(this->graphMutex_);
+		this->jobs_.emplace_back();
+		job = &this->jobs_.back();
+		id = this->jobs_.size() - 1;
+		job->fn = std::move(fn);
+		for (auto dep : deps) {
+			Job &d = this->jobs_[dep];
+			if (!d.done) {
+				d.successors.push_back(id);
+				++job->pending;
+			}
+		}
+		++this->unfinished_;
+		if (job->pending > 0)
+			return id;
+	}
+	this->schedule(id);
+	return id;
+}
+
+
+void JobSystem::wait() {
+	while (this->unfinished_.load() > 0) {
+		if (!this->tryRun(NOT_WORKER)) {
+			std::unique_lock<std::mutex> lock(this->sleepMutex_);
+			this->idle_.wait_for(lock, std::chrono::milliseconds(1),
+				[this] { return this->unfinished_.load() == 0; });
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(this->graphMutex_);
+	this->jobs_.clear();
+}
+
+
+void JobSystem::schedule(JobId id) {
+	std::size_t q = (tlsOwner == this) ? tlsWorker : this->next_++ % this->queues_.size();
+	{
+		// Counted before it can be taken, so tryRun never takes queued_ below 0
+		std::lock_guard<std::mutex> lock(this->queues_[q]->mutex);
+		++this->queued_;
+		this->queues_[q]->jobs.push_back(id);
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex_);
+	}
+	this->wake_.notify_one();
+}
+
+
+bool JobSystem::tryRun(std::size_t self) {
+	JobId id = 0;
+	bool found = false;
+
+	// Own deque first, newest job
+	if (self != NOT_WORKER) {
+		WorkQueue &own = *this->queues_[self];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty()) {
+			id = own.jobs.back();
+			own.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	// Steal the oldest job of another worker
+	std::size_t n = this->queues_.size();
+	std::size_t start = self == NOT_WORKER ? 0 : self + 1;
+	for (std::size_t k = 0; !found && k < n; ++k) {
+		WorkQueue &victim = *this->queues_[(start + k) % n];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty()) {
+			id = victim.jobs.front();
+			victim.jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found)
+		return false;
+
+	--this->queued_;
+	this->run(id);
+	return true;
+}
+
+
+void JobSystem::run(JobId id) {
+	std::function<void()> fn;
+	{
+		std::lock_guard<std::mutex> lock(this->graphMutex_);
+		fn = std::move(this->jobs_[id].fn);
+	}
+
+	fn();
+
+	std::vector<JobId> ready;
+	{
+		std::lock_guard<std::mutex> lock(this->graphMutex_);
+		Job &job = this->jobs_[id];
+		job.done = true;
+		for (auto s : job.successors) {
+			if (--this->jobs_[s].pending == 0)
+				ready.push_back(s);
+		}
+		job.successors.clear();
+	}
+	for (auto s : ready)
+		this->schedule(s);
+
+	if (--this->unfinished_ == 0) {
+		std::lock_guard<std::mutex> lock(this->sleepMutex_);
+		this->idle_.notify_all();
+	}
+}
+
+
+void JobSystem::workerLoop(std::size_t self) {
+	tlsOwner = this;
+	tlsWorker = self;
+
+	while (!this->quit_.load()) {
+		if (this->tryRun(self))
+			continue;
+
+		std::unique_lock<std::mutex> lock(this->sleepMutex_);
+		this->wake_.wait(lock, [this] { return this->quit_.load() || this->queued_.load() > 0; });
+	}
+}
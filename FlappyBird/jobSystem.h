@@ -0,0 +1,76 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/*
+\  Job system with one work-stealing deque per worker and a dependency graph.
+\  A worker pops its own deque from the back (LIFO, cache friendly) and steals
+\  from the front of the others (FIFO) when it runs dry.
+*/
+class JobSystem {
+public:
+	using JobId = std::size_t;
+
+	// workers == 0 uses std::thread::hardware_concurrency()
+	explicit JobSystem(std::size_t workers = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem &) = delete;
+	JobSystem(JobSystem &&) = delete;
+	JobSystem& operator=(const JobSystem &) = delete;
+	JobSystem& operator=(JobSystem &&) = delete;
+
+	// The job runs after every job in deps has finished.
+	// Ids stay valid until wait() returns.
+	JobId add(std::function<void()> fn, const std::vector<JobId> &deps = {});
+
+	// Block until every added job has finished; the calling thread helps
+	void wait();
+
+	std::size_t workers() const noexcept { return this->threads_.size(); }
+
+private:
+	struct Job {
+		std::function<void()> fn;
+		std::vector<JobId> successors;
+		int pending = 0;
+		bool done = false;
+	};
+
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<JobId> jobs;
+	};
+
+	void schedule(JobId id);
+	bool tryRun(std::size_t self);
+	void run(JobId id);
+	void workerLoop(std::size_t self);
+
+	std::vector<std::unique_ptr<WorkQueue>> queues_;
+	std::vector<std::thread> threads_;
+
+	// Graph, guarded by graphMutex_. std::deque keeps references stable on push_back.
+	std::mutex graphMutex_;
+	std::deque<Job> jobs_;
+
+	std::mutex sleepMutex_;
+	std::condition_variable wake_;
+	std::condition_variable idle_;
+	std::atomic<std::size_t> queued_;
+	std::atomic<std::size_t> unfinished_;
+	std::atomic<std::size_t> next_;
+	std::atomic<bool> quit_;
+};
+
+#endif // !JOBSYSTEM_H
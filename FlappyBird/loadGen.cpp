@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <random>
+#include "loadGen.h"
+#include "netProtocol.h"
+
+
+namespace {
+	// Connections opened per loop, so the listen backlog is not flooded
+	constexpr std::size_t CONNECT_BATCH = 256;
+}
+
+
+LoadStats LoadGenerator::run(std::ostream &report) {
+	using clock = std::chrono::steady_clock;
+	net::startUp();
+
+	LoadStats stats;
+	std::vector<Client> clients(this->sessions_);
+	std::default_random_engine e(12345);
+	std::uniform_real_distribution<float> bias(-60.0f, 20.0f);
+	for (std::size_t i = 0; i < clients.size(); ++i) {
+		clients[i].seed = static_cast<std::uint32_t>(i);
+		clients[i].bias = bias(e);
+	}
+
+	// Clients still to connect; refused ones go back to the end
+	std::deque<std::size_t> waiting;
+	for (std::size_t i = 0; i < clients.size(); ++i)
+		waiting.push_back(i);
+
+	std::vector<net::Poller::Event> events;
+	auto start = clock::now();
+	auto nextReport = start + std::chrono::seconds(1);
+	LoadStats last;
+
+	while (clock::now() - start < std::chrono::duration<double>(this->seconds_)) {
+		for (std::size_t n = 0; n < CONNECT_BATCH && !waiting.empty(); ++n) {
+			std::size_t i = waiting.front();
+			waiting.pop_front();
+			Client &c = clients[i];
+			c.socket = net::connectLocal(this->port_);
+			// Writable once the connection is up
+			this->poller_.add(c.socket, i, true);
+			c.writing = true;
+		}
+
+		this->poller_.wait(5, events);
+		for (const auto &ev : events) {
+			Client &c = clients[static_cast<std::size_t>(ev.key)];
+			if (c.socket == net::INVALID)
+				continue;
+			if (ev.error) {
+				this->poller_.remove(c.socket);
+				net::close(c.socket);
+				c.socket = net::INVALID;
+				if (c.connected)
+					--stats.connected;
+				else
+					waiting.push_back(static_cast<std::size_t>(ev.key));
+				continue;
+			}
+			if (ev.writable && !c.connected) {
+				c.connected = true;
+				++stats.connected;
+				net::writeJoin(c.out, { c.seed, 1 });
+			}
+			if (ev.readable)
+				this->receive(c, stats);
+			if (c.socket != net::INVALID)
+				this->flush(c, ev.key);
+		}
+
+		auto now = clock::now();
+		if (now >= nextReport) {
+			report << std::setw(6) << std::chrono::duration_cast<std::chrono::seconds>(now - start).count() << "s"
+				<< "  connected " << std::setw(6) << stats.connected
+				<< "  snapshots/s " << std::setw(8) << stats.snapshots - last.snapshots
+				<< "  inputs/s " << std::setw(7) << stats.inputs - last.inputs
+				<< "  KB/s in " << std::setw(8) << (stats.bytesIn - last.bytesIn) / 1024
+				<< "  B/snapshot " << std::setw(5) << std::fixed << std::setprecision(1)
+				<< static_cast<double>(stats.bytesIn - last.bytesIn) / std::max<std::uint64_t>(stats.snapshots - last.snapshots, 1)
+				<< "  games " << stats.games << "\n";
+			last = stats;
+			nextReport += std::chrono::seconds(1);
+		}
+	}
+
+	for (auto &c : clients) {
+		if (c.socket != net::INVALID) {
+			this->poller_.remove(c.socket);
+			net::close(c.socket);
+		}
+	}
+	stats.seconds = std::chrono::duration<double>(clock::now() - start).count();
+	return stats;
+}
+
+
+void LoadGenerator::receive(Client &c, LoadStats &stats) {
+	std::uint8_t buffer[4096];
+	for (;;) {
+		long n = net::recv(c.socket, buffer, sizeof(buffer));
+		if (n < 0) {
+			this->poller_.remove(c.socket);
+			net::close(c.socket);
+			c.socket = net::INVALID;
+			--stats.connected;
+			return;
+		}
+		if (n == 0)
+			break;
+		c.in.insert(c.in.end(), buffer, buffer + n);
+		stats.bytesIn += n;
+	}
+
+	std::size_t pos = 0;
+	bool fresh = false;
+	net::Snapshot s;
+	for (;;) {
+		long size = net::messageSize(c.in.data() + pos, c.in.size() - pos);
+		if (size < 0) {
+			// Lost framing: nothing after this can be trusted
+			++stats.badSnapshots;
+			pos = c.in.size();
+			break;
+		}
+		if (size == 0 || c.in.size() - pos < static_cast<std::size_t>(size))
+			break;
+		bool ok = c.in[pos] == net::MSG_SNAPSHOT && net::readSnapshot(c.in.data() + pos, c.history, s);
+		pos += size;
+		if (!ok) {
+			++stats.badSnapshots;
+			continue;
+		}
+		++stats.snapshots;
+		fresh = !s.over;
+
+		if (s.over) {
+			++stats.games;
+			stats.bestScore = std::max(stats.bestScore, static_cast<int>(s.score));
+			c.seed += static_cast<std::uint32_t>(this->sessions_);
+			c.flapTick = 0;
+			net::writeJoin(c.out, { c.seed, 1 });
+		}
+	}
+
+	// One ack for the newest snapshot is enough
+	if (fresh)
+		net::writeAck(c.out, s.tick);
+
+	// Steer on the newest snapshot only, and not again before the last flap shows up
+	if (fresh && s.tick >= c.flapTick) {
+		// Aim at the first tube the bird has not passed yet, like GameSim::autoFlap
+		net::Quantization q;
+		float y = q.position(s.birdY);
+		for (std::uint8_t i = 0; i < s.tubeCount; ++i) {
+			if (s.tubeX[i] + s.scroll < 0)
+				continue;
+			if (s.birdV <= 0 && y < q.position(s.tubeY[i]) + c.bias) {
+				c.flapTick = s.tick + 1;
+				net::writeInput(c.out, { c.flapTick, true });
+				++stats.inputs;
+			}
+			break;
+		}
+	}
+	c.in.erase(c.in.begin(), c.in.begin() + pos);
+}
+
+
+void LoadGenerator::flush(Client &c, std::uint64_t key) {
+	std::size_t sent = 0;
+	while (sent < c.out.size()) {
+		long n = net::send(c.socket, c.out.data() + sent, c.out.size() - sent);
+		if (n <= 0)
+			break;
+		sent += n;
+	}
+	c.out.erase(c.out.begin(), c.out.begin() + sent);
+
+	bool pending = !c.out.empty() || !c.connected;
+	if (pending != c.writing) {
+		this->poller_.modify(c.socket, key, pending);
+		c.writing = pending;
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "netSocket.h"
+#include "snapshotCodec.h"
+
+
+// Totals of one load run
+struct LoadStats {
+	std::size_t connected = 0;
+	std::uint64_t snapshots = 0;
+	std::uint64_t inputs = 0;
+	std::uint64_t games = 0;          // finished games
+	std::uint64_t bytesIn = 0;
+	std::uint64_t badSnapshots = 0;
+	int bestScore = 0;
+	double seconds = 0.0;
+};
+
+
+/*
+\  Load generator for SessionHost: opens many client connections from one
+\  thread, joins a game on each and flies every bird with the same autopilot
+\  as GameSim::autoFlap, driven only by the snapshots it decodes and acks.
+*/
+class LoadGenerator {
+public:
+	LoadGenerator(std::uint16_t port, std::size_t sessions, double seconds)
+		: port_(port), sessions_(sessions), seconds_(seconds) {}
+
+	// Print one line per second to report and return the totals
+	LoadStats run(std::ostream &report);
+
+private:
+	struct Client {
+		net::Socket socket = net::INVALID;
+		bool connected = false;
+		bool writing = false;
+		std::uint32_t seed = 0;
+		std::uint32_t flapTick = 0;    // tick of the last flap sent
+		float bias = 0.0f;
+		net::SnapshotHistory history;
+		std::vector<std::uint8_t> in;
+		std::vector<std::uint8_t> out;
+	};
+
+	void receive(Client &c, LoadStats &stats);
+	void flush(Client &c, std::uint64_t key);
+
+	std::uint16_t port_;
+	std::size_t sessions_;
+	double seconds_;
+	net::Poller poller_;
+};
+
+#endif // !LOADGEN_H
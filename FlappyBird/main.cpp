@@ -3,18 +3,31 @@
 #include <memory>
 #include <vector>
 #include <random>
+#include <cstring>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
 #include "gl\glew.h"
 #include "gl\freeglut.h"
 #include "glm\glm.hpp"
 #include "shader.h"
 #include "board.h"
-#include "bird.h"
-#include "tube.h"
-#include "particle_generator.h"
-#include "collisionWorld.h"
-#include "SoundManager.h"
 #include "button.h"
-#include "scoreBoard.h"
+#include "gameContext.h"
+#include "gameView.h"
+#include "ui.h"
+#include "screen.h"
+#include "renderScaler.h"
+#include "gameRunner.h"
+#include "sessionHost.h"
+#include "loadGen.h"
+#include "snapshotBench.h"
+#include "collisionBench.h"
+#include "courseBench.h"
+#include "audioBench.h"
+#include "assetLoader.h"
+#include "assetPack.h"
 #include "config.h"
 
 
@@ -24,77 +37,138 @@ using std::unique_ptr;
 
 
 void init();
+void loading();
 void display();
 void spaceDown(unsigned char key, int, int);
 void spaceUp(unsigned char key, int, int);
 void mouseClick(int button, int state, int x, int y);
+void reshape(int width, int height);
+void redrawTimer(int);
+
+
+// 进程共享的资源, 当前游戏世界, 菜单界面, 启动时的资源加载器
+// GLUT callbacks take no user pointer, so these are the only globals
+unique_ptr<SharedResources> pShared;
+unique_ptr<GameContext> pGame;
+unique_ptr<Ui> pUi;
+unique_ptr<AssetLoader> pLoader;
+unique_ptr<Screen> pScreen;
+
+// 每帧留给资源上传的时间(毫秒)
+const double LOAD_BUDGET_MS = 4.0;
+// 预处理过的资源包, 没有时读取散落的文件
+const char *ASSET_PACK = "assets.pack";
+
+
+// 打包全部贴图, 音效和着色器; 解码和生成mipmap都在这里离线完成
+bool writeAssetPack(const char *path) {
+	AssetPackWriter writer;
+	bool ok = true;
+
+	std::vector<const char*> textures = Ui::texturePaths();
+	for (auto tex : SharedResources::texturePaths())
+		textures.push_back(tex);
+	for (auto tex : textures) {
+		Image image = Image::decode(tex);
+		ok = !image.empty() && writer.addTexture(tex, image.width, image.height, image.pixels.data()) && ok;
+	}
 
+	for (auto snd : SharedResources::soundPaths()) {
+		std::vector<std::uint8_t> bytes;
+		PcmData pcm;
+		ok = readFile(snd, bytes) && decodeWav(bytes.data(), bytes.size(), pcm) && writer.addSound(snd, pcm) && ok;
+	}
 
-bool isStarted = false;
-bool isOver = false;
-bool isPaused = false;
-bool isSelectingMode = false;
-bool isSelectingSkin = false;
-bool isSpaceDown = false;
-
-bool startButtonDown = false;
-bool modeButtonDown = false;
-bool skinButtonDown = false;
-bool backButtonDown = false;
-bool easyButtonDown = false;
-bool normalButtonDown = false;
-bool hardButtonDown = false;
-bool originButtonDown = false;
-bool blueButtonDown = false;
-bool OKButtonDown = false;
-
-enum modeSet {Easy = 0, Normal = 1, Hard = 2};
-enum skinSet {Origin = 0, Blue = 1};
-
-GLint mode = Normal;
-GLint skin = Origin;
-
-GLfloat deltaTime = 0.0;
-GLfloat lastFrame = 0.0;
-GLfloat pausedTime = 0.0;
-
-constexpr std::size_t tubeNum = 999;
-constexpr std::size_t particleNum = 500;
-
-unique_ptr<Button> pStartButton;
-unique_ptr<Button> pOKButton;
-unique_ptr<Button> pBackButton;
-unique_ptr<Button> pModeButton;
-unique_ptr<Button> pEasyButton;
-unique_ptr<Button> pNormalButton;
-unique_ptr<Button> pHardButton;
-unique_ptr<Button> pSkinButton;
-unique_ptr<Button> pOriginButton;
-unique_ptr<Button> pBlueButton;
-unique_ptr<Board> pBackground;
-unique_ptr<Board> pTitle;
-unique_ptr<Board> pGameOver;
-unique_ptr<Bird> pBird;
-unique_ptr<ScoreBoard> pScore;
-std::vector<unique_ptr<Tube>> tubes;
-unique_ptr<Shader> pButtonShader;
-unique_ptr<Shader> pTubeShader;
-unique_ptr<Shader> pBoardShader;
-unique_ptr<Shader> pParticleShader;
-
-ParticleGenerator* particles;
-
-int currTube = 0;  // Index
-std::size_t wingSound;
-std::size_t pointSound;
-std::size_t dieSound;
-std::size_t hitSound;
-std::size_t clickSound;
+	for (auto src : Ui::shaderPaths()) {
+		std::vector<std::uint8_t> bytes;
+		ok = readFile(src, bytes) && writer.addText(src, std::string(bytes.begin(), bytes.end())) && ok;
+	}
+
+	if (!ok) {
+		cerr << "some assets could not be packed" << endl;
+		return false;
+	}
+	if (!writer.write(path))
+		return false;
+	std::cout << "packed " << writer.entries() << " assets into " << path << endl;
+	return true;
+}
 
 
 int main(int argc, char **argv) {
+	// 无界面批量模拟: FlappyBird --bench-headless [games]
+	if (argc > 1 && std::strcmp(argv[1], "--bench-headless") == 0) {
+		std::size_t games = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+		GameRunner(games).reportScaling(std::cout);
+		return 0;
+	}
+
+	// 快照编码测试: FlappyBird --bench-snapshot [games]
+	if (argc > 1 && std::strcmp(argv[1], "--bench-snapshot") == 0) {
+		std::size_t games = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+		return SnapshotBench(games).report(std::cout) ? 0 : EXIT_FAILURE;
+	}
+
+	// 碰撞检测测试: FlappyBird --bench-collision [boxes]
+	if (argc > 1 && std::strcmp(argv[1], "--bench-collision") == 0) {
+		std::size_t boxes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+		return CollisionBench(boxes).report(std::cout) ? 0 : EXIT_FAILURE;
+	}
+
+	// 关卡生成检查: FlappyBird --bench-course [seeds]
+	if (argc > 1 && std::strcmp(argv[1], "--bench-course") == 0) {
+		std::size_t seeds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+		return CourseBench(seeds).report(std::cout) ? 0 : EXIT_FAILURE;
+	}
+
+	// 离线音频测试: FlappyBird --bench-audio [games] [file.wav]
+	if (argc > 1 && std::strcmp(argv[1], "--bench-audio") == 0) {
+		std::size_t games = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+		std::vector<BenchSound> sounds;
+		auto paths = SharedResources::soundPaths();
+		auto params = SharedResources::soundParams();
+		for (std::size_t i = 0; i < 4; ++i)     // wing, point, die, hit
+			sounds.push_back({ paths[i], params[i] });
+		return AudioBench(games, sounds, "sounds//sfx_swooshing.wav").report(std::cout, argc > 3 ? argv[3] : "") ? 0 : EXIT_FAILURE;
+	}
+
+	// 生成资源包: FlappyBird --pack [file]
+	if (argc > 1 && std::strcmp(argv[1], "--pack") == 0)
+		return writeAssetPack(argc > 2 ? argv[2] : ASSET_PACK) ? 0 : EXIT_FAILURE;
+
+	// 服务器模式: FlappyBird --host [port]
+	if (argc > 1 && std::strcmp(argv[1], "--host") == 0) {
+		HostConfig config;
+		config.port = static_cast<std::uint16_t>(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : config.port);
+		JobSystem jobs;
+		SessionHost host(jobs, config);
+		std::cout << "session host on 127.0.0.1:" << host.port() << ", " << jobs.workers() << " workers" << endl;
+		std::atomic<bool> stop(false);
+		host.run(stop);
+		return 0;
+	}
+
+	// 压力测试客户端: FlappyBird --loadgen port [sessions] [seconds]
+	if (argc > 2 && std::strcmp(argv[1], "--loadgen") == 0) {
+		auto port = static_cast<std::uint16_t>(std::strtoul(argv[2], nullptr, 10));
+		std::size_t sessions = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10000;
+		double seconds = argc > 4 ? std::strtod(argv[4], nullptr) : 10.0;
+		LoadStats r = LoadGenerator(port, sessions, seconds).run(std::cout);
+		std::cout << "connected " << r.connected << ", snapshots " << r.snapshots << ", inputs " << r.inputs
+			<< ", games " << r.games << ", best score " << r.bestScore << ", bad snapshots " << r.badSnapshots << endl;
+		return 0;
+	}
+
+	// 显示设置: --vsync 0|1, --fps N, --scale S, --min-scale S, --latency, --stats
+	DisplayConfig displayConfig = DisplayConfig::parse(argc, argv);
+
+#ifdef _WIN32
+	// Real pixels on high-DPI monitors instead of a bitmap-stretched window
+	SetProcessDPIAware();
+#endif
+
 	glutInit(&argc, argv);
-	glutInitDisplayMode(GLUT_RGBA);
+	glutInitDisplayMode(GLUT_RGBA | GLUT_DOUBLE | GLUT_DEPTH);
 	glutInitWindowSize(SCREENWIDTH, SCREENHEIGTH);
 	glutInitContextVersion(4, 3);
 	glutInitContextProfile(GLUT_CORE_PROFILE);
@@ -105,8 +179,13 @@ int main(int argc, char **argv) {
 		std::exit(EXIT_FAILURE);
 	}
 
+	// 虚拟分辨率为初始窗口大小, 窗口改变时加黑边保持比例
+	pScreen = std::make_unique<Screen>(displayConfig, SCREENWIDTH, SCREENHEIGTH);
+	pScreen->resize(glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT));
+
+	pShared = std::make_unique<SharedResources>();
 	// 设置音效管理
-	SoundManager::setUp(argc, argv);
+	pShared->sound = std::make_unique<SoundManager>(argc, argv);
 
 	init();
 
@@ -115,363 +194,213 @@ int main(int argc, char **argv) {
 	glutKeyboardFunc(spaceDown);
 	glutKeyboardUpFunc(spaceUp);
 	glutMouseFunc(mouseClick);
+	glutReshapeFunc(reshape);
 
 	glutMainLoop();
 }
 
 
 
+// 把资源交给后台线程解码, 第一帧马上显示加载画面
 void init() {
 	glEnable(GL_DEPTH_TEST);
 
-	utility::CollisionWorld::setUp();
-
-	pStartButton = std::make_unique<Button>("texture//startButton.png");
-	pModeButton = std::make_unique<Button>("texture//modeButton.png", glm::vec3{ -150.0f, -170.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pBackButton = std::make_unique<Button>("texture//backButton.png", glm::vec3{ 0.0f, -360.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pEasyButton = std::make_unique<Button>("texture//easyButton.png", glm::vec3{ 0.0f, -120.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pNormalButton = std::make_unique<Button>("texture//normalButton.png", glm::vec3{ 0.0f, -200.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pHardButton = std::make_unique<Button>("texture//hardButton.png", glm::vec3{ 0.0f, -280.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pSkinButton = std::make_unique<Button>("texture//skinButton.png", glm::vec3{ 150.0f, -170.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pOriginButton = std::make_unique<Button>("texture//originButton.png", glm::vec3{ 0.0f, -120.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pBlueButton = std::make_unique<Button>("texture//blueButton.png", glm::vec3{ 0.0f, -240.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pOKButton = std::make_unique<Button>("texture//OKButton.png", glm::vec3{ 0.0f, 0.0f, 0.0f }, glm::vec3{ 1.41f, 0.5f, 1.0f });
-	pButtonShader = std::make_unique<Shader>("board.vert", "board.frag");
-
-	pTitle = std::make_unique<Board>("texture//title.png", glm::vec3{ 0.0f, 200.0f, 0.0f }, glm::vec3{ 2.2f, 2.0f, 1.0f });
-	pGameOver = std::make_unique<Board>("texture//gameOver.png", glm::vec3{ 0.0f, 250.0f, 0.0f }, glm::vec3{ 4.0f, 4.0f, 1.0f });
-
-	pBackground = std::make_unique<Board>("texture//background.png", glm::vec3{0.0f, 0.0f, 0.0f}, glm::vec3{10.0f, 10.0f, 1.0f});
-	
-	pBoardShader = std::make_unique<Shader>("board.vert", "board.frag");
-
-	pScore = std::make_unique<ScoreBoard>(glm::vec3{ 0.0f, 400.0f, 0.0f }, glm::vec3{ 0.26f, 0.36f, 1.0f }, 0);
-
-	pTubeShader = std::make_unique<Shader>("tube.vert", "tube.frag");
-
-	pParticleShader = std::make_unique<Shader>("particle.vert", "particle.frag");
-	particles = new ParticleGenerator(particleNum);
-
-	auto pSoundManager = SoundManager::instance();
-	wingSound = pSoundManager->load("sounds//wing.wav");
-	pointSound = pSoundManager->load("sounds//point.wav");
-	dieSound = pSoundManager->load("sounds//die.wav");
-	hitSound = pSoundManager->load("sounds//hit.wav");
-	clickSound = pSoundManager->load("sounds//buttonClick.wav");
+#ifdef _DEBUG
+	// 调试版: 保存着色器文件后自动重新编译, 不用重启
+	pShared->shaders.watchFiles(true);
+	// Idle screens are not redrawn on their own, so look for edits 4 times a second
+	glutTimerFunc(250, redrawTimer, 0);
+#endif
+
+	pShared->pack.open(ASSET_PACK);
+	pLoader = std::make_unique<AssetLoader>(pShared->textures, pShared->shaders, pShared->sound.get(), &pShared->pack);
+	AssetLoader &loader = *pLoader;
+	Ui::loadTextures(loader);
+	pShared->loadTextures(loader);
+	pShared->loadSounds(loader);
+
+	// Runs on the render thread once every texture and sound is uploaded
+	loader.task([] {
+		pGame = std::make_unique<GameContext>(*pShared);
+		if (pScreen->config().measureLatency)
+			pGame->latency = std::make_unique<LatencyMeter>();
+		if (pScreen->config().stats)
+			pGame->log = &std::cout;
+	});
+	loader.task([] {
+		pUi = std::make_unique<Ui>(*pShared, *pGame);
+		pUi->resize(pScreen->windowHeight(), pScreen->viewport());
+	});
+	loader.task([] { pUi->loadShaders(*pLoader); });
 }
 
 
-// 重置游戏
-void reInit() {
-	pBird = std::make_unique<Bird>(glm::vec3{ 0.0f, -109.693f, 0.0f }, mode, skin);
-	std::default_random_engine e;
-	tubes.clear();
-	GLfloat halfSpace = (mode == 1 || mode == 2) ? 130.0f : 180.0f;
-	for (int i = 0; i < tubeNum; ++i) {
-		tubes.emplace_back(std::make_unique<Tube>(
-			glm::vec3(500.0f + 400.0f * static_cast<float>(i), (static_cast<int>(e() % 6) - 3) * 80.0f, 0.0f)
-			, halfSpace, 0.0f));
+// 加载画面: 上传一部分资源, 画进度条
+void loading() {
+	static bool firstFrame = true;
+	if (firstFrame) {
+		if (pScreen->config().stats)
+			std::cout << "first frame after " << glutGet(GLUT_ELAPSED_TIME) << " ms" << endl;
+		firstFrame = false;
 	}
-	currTube = 0;
-	pScore->setValue(0);
-}
 
+	bool ready = pLoader->pump(LOAD_BUDGET_MS);
 
+	// Progress bar from scissored clears, needs no shader or texture
+	int width = glutGet(GLUT_WINDOW_WIDTH), height = glutGet(GLUT_WINDOW_HEIGHT);
+	int barWidth = width * 3 / 5, barHeight = height / 30 + 1;
+	int x = (width - barWidth) / 2, y = (height - barHeight) / 2;
 
-void display() {
 	glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-	GLfloat currFrame = 0.0001f * glutGet(GLUT_ELAPSED_TIME);
-	deltaTime = currFrame - lastFrame;
-	lastFrame = currFrame;
-	if (isPaused) {
-		//pausedTime += deltaTime;
-		deltaTime = 0;
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(x, y, barWidth, barHeight);
+	glClearColor(0.1f, 0.15f, 0.15f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glScissor(x, y, static_cast<GLsizei>(barWidth * pLoader->progress()), barHeight);
+	glClearColor(0.95f, 0.75f, 0.2f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
+	glutSwapBuffers();
+
+	if (ready) {
+		const ShaderCache &shaders = pShared->shaders;
+		if (pScreen->config().stats)
+			std::cout << "assets ready after " << glutGet(GLUT_ELAPSED_TIME) << " ms, shaders compiled " << shaders.compiled()
+				<< ", from disk " << shaders.loaded() << ", shared " << shaders.shared() << endl;
+		pLoader.reset();
+		pShared->pack.close();    // everything in it is on the GPU or in OpenAL now
 	}
+}
 
-	// 如果游戏还未开始,画开始按钮,标题
-	if (!isStarted) {
-		pButtonShader->use();
-		if (isSelectingMode) {
-			pBackButton->draw(*pButtonShader);
-			pEasyButton->draw(*pButtonShader);
-			pNormalButton->draw(*pButtonShader);
-			pHardButton->draw(*pButtonShader);
-		}
-		else if (isSelectingSkin) {
-			pBackButton->draw(*pButtonShader);
-			pOriginButton->draw(*pButtonShader);
-			pBlueButton->draw(*pButtonShader);
-		}
-		else {
-			pStartButton->draw(*pButtonShader);
-			pModeButton->draw(*pButtonShader);
-			pSkinButton->draw(*pButtonShader);
-		}
 
-		pBoardShader->use();
-		pTitle->draw(*pBoardShader);
 
-		// 如果上一次游戏结束,重新开始
-		if (isOver) {
-			isOver = false;
-			reInit();
-		}
-	}
-	// 如果游戏结束，画出重新开始的按钮，提示
-	else if (isOver) {
-		pBoardShader->use();
-		pGameOver->draw(*pBoardShader);
-		pButtonShader->use();
-		pOKButton->draw(*pButtonShader);
+void display() {
+	if (pLoader) {
+		loading();
+		return;
 	}
-	// 如果游戏正在进行，画出积分板，画鸟，画管子
-	else {
-		pBoardShader->use();
-		pScore->draw(*pBoardShader);
-
-		pBoardShader->use();
-
-		if (!isPaused) {
-			// 暂停时不改变鸟的绘制状态
 
-			if (isSpaceDown) {
-				pBird->fly();
-			}
+	// Frame boundary: swap in shaders whose files were edited
+	pShared->shaders.update();
 
-			pBird->fall(deltaTime);
+	GameContext &game = *pGame;
+	Ui &ui = *pUi;
 
-			// 确定翅膀扇动的频率
-			static int flutterRate = 0;
-			++flutterRate;
-			if (flutterRate % 10 == 0)
-				pBird->flutter();
+	pScreen->begin();
+	pShared->frames.beginFrame();
+	glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-			// 绘制粒子效果
-			//pParticleShader->use();
-			//particles->update(deltaTime, pBird->getPosition2f(), glm::vec2{ -2500.0f, pBird->getVelocityY() }, 2, glm::vec2(pBird->getHalfEdge()));
-			//particles->draw(*pParticleShader);
+	ui.nowMs = InputQueue::nowMs();
+	GLfloat currFrame = static_cast<GLfloat>(0.0001 * ui.nowMs);
+	// First frame after an idle screen: no game time passed, and the gap is no stutter
+	if (!ui.animating) {
+		ui.lastFrame = currFrame;
+		pScreen->pacer().restart();
+	}
+	ui.deltaTime = currFrame - ui.lastFrame;
+	ui.lastFrame = currFrame;
+
+	// 只更新和绘制当前界面(暂停时画出下面冻结的游戏)
+	ui.scenes.update(ui.deltaTime);
+	ui.scenes.draw();
+
+	// Sounds, effects and telemetry of this frame's input and step
+	game.events.dispatch();
+
+	ui.pBackground->scroll(game.scrolled());
+	ui.pBackground->submit(ui.queue, *ui.pParallaxShader, RenderLayer::Background);
+	ui.submitHud(game);
+	ui.renderer.flush(ui.queue);
+
+	pShared->frames.endFrame();
+	pScreen->end();
+	if (game.latency)
+		game.latency->presented(InputQueue::nowMs());
+
+	// 静止的界面(菜单, 暂停, 结束)不再连续重绘, 有输入时才画下一帧
+	bool animating = ui.scenes.animated();
+	if (ui.animating && !animating) {
+		if (pScreen->config().stats) {
+			std::cout << "frame pacing: ";
+			pScreen->pacer().report(std::cout);
+			std::cout << "render queue: ";
+			ui.queue.report(std::cout);
 		}
-
-		pBird->draw(*pBoardShader);
-
-		// 绘制粒子效果
-		pParticleShader->use();
-		particles->update(deltaTime, pBird->getPosition2f(), glm::vec2{ 2500.0f, pBird->getVelocityY() }, 2, glm::vec2(pBird->getHalfEdge()));
-		particles->draw(*pParticleShader);
-
-		pTubeShader->use();
-
-		for (auto& ptube : tubes) {
-			ptube->shift(deltaTime);
-			ptube->draw(*pTubeShader);
-		}
-
-		if (currTube < tubes.size()) {
-
-			// 如果和当前tube或者前一个tube碰撞
-			if (currTube > 0
-				? pBird->collisionDetect(tubes[currTube]->getDownBox())
-				|| pBird->collisionDetect(tubes[currTube]->getUpBox())
-				|| pBird->collisionDetect(tubes[currTube - 1]->getDownBox())
-				|| pBird->collisionDetect(tubes[currTube - 1]->getUpBox())
-				: pBird->collisionDetect(tubes[currTube]->getDownBox()) || pBird->collisionDetect(tubes[currTube]->getUpBox())) {
-				// cout << "\nCollide\n";
-				// system("Pause");
-				SoundManager::instance()->play(hitSound);
-				SoundManager::instance()->play(dieSound);
-				isOver = true;
-			}
-
-			if (pBird->out()) {
-				SoundManager::instance()->play(hitSound);
-				SoundManager::instance()->play(dieSound);
-				isOver = true;
-			}
-
-			// 如果通过当前的tube
-			if (pBird->position().x > tubes[currTube]->position().x) {
-				pScore->setValue(pScore->getValue() + 1);
-				++currTube;
-				SoundManager::instance()->play(pointSound);
-			}
+		pScreen->pacer().clearStats();
+		ui.queue.clearStats();
+		if (game.latency) {
+			std::cout << "input latency: ";
+			game.latency->report(std::cout, pScreen->pacer().target() > 0.0 ? pScreen->pacer().target() : 1000.0 / 60.0);
+			game.latency->clear();
 		}
 	}
-
-	pBoardShader->use();
-	pBackground->draw(*pBoardShader);
-
-	/*
-	if (isStarted && !isOver) {
-		// 绘制粒子效果
-		pParticleShader->use();
-		particles->update(deltaTime, pBird->getPosition2f(), glm::vec2{ -2500.0f, pBird->getVelocityY() }, 2, glm::vec2(pBird->getHalfEdge()));
-		particles->draw(*pParticleShader);
-	}*/
-
- 	glFlush();
+	ui.animating = animating;
+	glutIdleFunc(animating ? display : nullptr);
 }
 
 
 // 判断空格是否按下
 void spaceDown(unsigned char key, int, int) {
-	if (key == ' ') {
-		if (isStarted && !isOver && !isPaused) {
-			SoundManager::instance()->play(wingSound);		
-		}
-		isSpaceDown = true;
+	// 加载中不响应输入
+	if (pLoader)
+		return;
+
+	// Queued with its time; the game applies it at the tick it happened in.
+	// Only while playing: a press in a menu or the pause screen is not a flap
+	if (key == ' ' && pUi->scenes.top() == &pUi->playing) {
+		pGame->input.push(InputEvent::Press, key);
 	}
 
-	if (key == 'a') {
-		for (auto &ptube : tubes) {
-			std::cout << "(" <<
-				ptube->position().x <<
-				", " << ptube->position().y << ")\n";
-			}
- 		int a = 1;
-	}
+	if (key == 'h')
+		pUi->showHud = !pUi->showHud;
 
-	// 暂停
-	if (key == 'p') {
-		if (isStarted && !isOver) {
-			//isPaused = isPaused ? false : true;
-			if (!isPaused) {
-				isPaused = true;
-				pScore->setPause();
-			}
-			else {
-				isPaused = false;
-				pScore->setRun();
-			}
-		}
-	}
+	pUi->scenes.keyDown(key);
+	glutPostRedisplay();
 }
 
 // 判断空格是否抬起
 void spaceUp(unsigned char key, int, int) {
-	if (key == ' ') {
-		isSpaceDown = false;
+	// 加载中不响应输入
+	if (pLoader)
+		return;
+
+	GameContext &game = *pGame;
+
+	if (key == ' ' && pUi->scenes.top() == &pUi->playing) {
+		game.input.push(InputEvent::Release, key);
 	}
+	glutPostRedisplay();
 }
 
-// 处理鼠标点击事件
+// 处理鼠标点击事件, 只交给当前界面
 void mouseClick(int button, int state, int x, int y) {
+	// 加载中不响应输入
+	if (pLoader)
+		return;
+
 	if (button == GLUT_LEFT_BUTTON) {
 		if (state == GLUT_DOWN) {
 			cout << x << " " << y << endl;
-			if (!isStarted && pStartButton->cover(x, y)) {
-				pStartButton->down();
-				startButtonDown = true;
-				reInit();
-				SoundManager::instance()->play(clickSound);
-			}
-			if (isOver && pOKButton->cover(x, y)) {
-				pOKButton->down();
-				OKButtonDown = true;
-				reInit();
-				SoundManager::instance()->play(clickSound);
-			}
-			if (!isStarted && pModeButton->cover(x, y)) {
-				pModeButton->down();
-				modeButtonDown = true;
-				SoundManager::instance()->play(clickSound);
-			}
-			if (!isStarted && pSkinButton->cover(x, y)) {
-				pSkinButton->down();
-				skinButtonDown = true;
-				SoundManager::instance()->play(clickSound);
-			}
-			if (!isStarted && (isSelectingMode || isSelectingSkin) && pBackButton->cover(x, y)) {
-				pBackButton->down();
-				backButtonDown = true;
-				reInit();
-				SoundManager::instance()->play(clickSound);
-			}
-			if (!isStarted && isSelectingMode && pEasyButton->cover(x, y)) {
-				pEasyButton->down();
-				easyButtonDown = true;
-				mode = Easy;
-				SoundManager::instance()->play(clickSound);
-			}
-			if (!isStarted && isSelectingMode && pNormalButton->cover(x, y)) {
-				pNormalButton->down();
-				normalButtonDown = true;
-				mode = Normal;
-				SoundManager::instance()->play(clickSound);
-			}
-			if (!isStarted && isSelectingMode && pHardButton->cover(x, y)) {
-				pHardButton->down();
-				hardButtonDown = true;
-				mode = Hard;
-				SoundManager::instance()->play(clickSound);
-			}
-			if (!isStarted && isSelectingSkin && pOriginButton->cover(x, y)) {
-				pOriginButton->down();
-				originButtonDown = true;
-				skin = Origin;
-				SoundManager::instance()->play(clickSound);
-			}
-			if (!isStarted && isSelectingSkin && pBlueButton->cover(x, y)) {
-				pBlueButton->down();
-				blueButtonDown = true;
-				skin = Blue;
-				SoundManager::instance()->play(clickSound);
-			}
+			pUi->scenes.mouseDown(x, y);
 		}
 		else if (state == GLUT_UP) {
-			if (!isStarted && startButtonDown) {
-				pStartButton->up();
-				startButtonDown = false;
-				isStarted = true;
-			}
-			if (isOver && OKButtonDown) {
-				pOKButton->up();
-				OKButtonDown = false;
-				isStarted = false;			
-			}
-			if (!isStarted && modeButtonDown) {
-				pModeButton->up();
-				modeButtonDown = false;
-				isSelectingMode = true;
-			}
-			if (!isStarted && skinButtonDown) {
-				pSkinButton->up();
-				skinButtonDown = false;
-				isSelectingSkin = true;
-			}
-			if (!isStarted && (isSelectingMode || isSelectingSkin) && backButtonDown) {
-				pBackButton->up();
-				backButtonDown = false;
-				isSelectingMode = false;
-				isSelectingSkin = false;
-				isStarted = false;
-			}
-			if (!isStarted && isSelectingMode && easyButtonDown) {
-				pEasyButton->up();
-				easyButtonDown = false;
-				mode = Easy;
-			}
-			if (!isStarted && isSelectingMode && normalButtonDown) {
-				pNormalButton->up();
-				normalButtonDown = false;
-				mode = Normal;
-			}			
-			if (!isStarted && isSelectingMode && hardButtonDown) {
-				pHardButton->up();
-				hardButtonDown = false;
-				mode = Hard;
-			}
-			if (!isStarted && isSelectingSkin && originButtonDown) {
-				pOriginButton->up();
-				originButtonDown = false;
-				skin = Origin;
-			}
-			if (!isStarted && isSelectingSkin && blueButtonDown) {
-				pBlueButton->up();
-				blueButtonDown = false;
-				skin = Blue;
-			}
+			pUi->scenes.mouseUp(x, y);
 		}
 	}
-}
\ No newline at end of file
+	glutPostRedisplay();
+}
+
+// 窗口大小改变, 重新计算黑边和视口, 记下视口供鼠标坐标换算
+void reshape(int width, int height) {
+	pScreen->resize(width, height);
+	if (pUi)
+		pUi->resize(pScreen->windowHeight(), pScreen->viewport());
+}
+
+// 定时重画一帧, 让静止界面也能换上修改过的着色器
+void redrawTimer(int) {
+	glutPostRedisplay();
+	glutTimerFunc(250, redrawTimer, 0);
+}
@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "musicPlayer.h"
+
+
+constexpr std::size_t MusicPlayer::RING_FRAMES;
+constexpr std::size_t MusicPlayer::CHUNK_FRAMES;
+
+
+namespace {
+	std::uint32_t get16(const std::uint8_t *p) {
+		return p[0] | (p[1] << 8);
+	}
+
+	std::uint32_t get32(const std::uint8_t *p) {
+		return get16(p) | (get16(p + 2) << 16);
+	}
+}
+
+
+bool WavStreamDecoder::open(const std::string &path) {
+	this->file_.open(path, std::ios::binary);
+	std::uint8_t header[16];
+	if (!this->file_.read(reinterpret_cast<char*>(header), 12)
+		|| std::string(reinterpret_cast<char*>(header), 4) != "RIFF"
+		|| std::string(reinterpret_cast<char*>(header + 8), 4) != "WAVE")
+		return false;
+
+	// Same chunk walk as decodeWav, without reading the samples
+	bool haveFormat = false;
+	while (this->file_.read(reinterpret_cast<char*>(header), 8)) {
+		std::string id(reinterpret_cast<char*>(header), 4);
+		std::uint32_t length = get32(header + 4);
+		if (id == "fmt " && length >= 16) {
+			if (!this->file_.read(reinterpret_cast<char*>(header), 16) || get16(header) != 1)
+				return false;
+			this->channels_ = static_cast<int>(get16(header + 2));
+			this->sampleRate_ = static_cast<int>(get32(header + 4));
+			this->bitsPerSample_ = static_cast<int>(get16(header + 14));
+			if (this->channels_ < 1 || this->channels_ > 2 || (this->bitsPerSample_ != 8 && this->bitsPerSample_ != 16) || this->sampleRate_ <= 0)
+				return false;
+			haveFormat = true;
+			length -= 16;
+		}
+		else if (id == "data") {
+			if (!haveFormat)
+				return false;
+			this->dataStart_ = this->file_.tellg();
+			this->dataFrames_ = length / (this->channels_ * this->bitsPerSample_ / 8);
+			this->position_ = 0;
+			return this->dataFrames_ > 0;
+		}
+		// Chunks are padded to even sizes
+		this->file_.seekg(length + (length & 1), std::ios::cur);
+	}
+	return false;
+}
+
+
+std::size_t WavStreamDecoder::read(std::int16_t *out, std::size_t frames) {
+	frames = std::min(frames, this->dataFrames_ - this->position_);
+	std::size_t frameBytes = static_cast<std::size_t>(this->channels_ * this->bitsPerSample_ / 8);
+	this->bytes_.resize(frames * frameBytes);
+	if (frames == 0 || !this->file_.read(reinterpret_cast<char*>(this->bytes_.data()), static_cast<std::streamsize>(this->bytes_.size())))
+		return 0;
+
+	for (std::size_t i = 0; i < frames; ++i) {
+		for (int c = 0; c < 2; ++c) {
+			std::size_t at = i * frameBytes + std::min(c, this->channels_ - 1) * (this->bitsPerSample_ / 8);
+			out[2 * i + c] = this->bitsPerSample_ == 16
+				? static_cast<std::int16_t>(get16(&this->bytes_[at]))
+				: static_cast<std::int16_t>((this->bytes_[at] - 128) << 8);
+		}
+	}
+	this->position_ += frames;
+	return frames;
+}
+
+
+bool WavStreamDecoder::rewind() {
+	this->file_.clear();
+	this->file_.seekg(this->dataStart_);
+	this->position_ = 0;
+	return static_cast<bool>(this->file_);
+}
+
+
+std::unique_ptr<StreamDecoder> openStreamDecoder(const std::string &path) {
+	std::string ext = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+	std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+	if (ext == ".wav") {
+		std::unique_ptr<WavStreamDecoder> wav(new WavStreamDecoder());
+		if (wav->open(path))
+			return wav;
+	}
+	return nullptr;
+}
+
+
+MusicPlayer::MusicPlayer(int sampleRate, bool worker) : sampleRate_(sampleRate) {
+	if (!worker)
+		return;
+	this->worker_ = std::thread([this] {
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		while (!this->stop_) {
+			lock.unlock();
+			this->decode();
+			lock.lock();
+			// A ring lasts RING_FRAMES / sampleRate (~370 ms); topping up every 20 ms is plenty
+			this->wake_.wait_for(lock, std::chrono::milliseconds(20), [this] { return this->stop_ || !this->requests_.empty(); });
+		}
+	});
+}
+
+
+MusicPlayer::~MusicPlayer() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		this->stop_ = true;
+	}
+	this->wake_.notify_one();
+	if (this->worker_.joinable())
+		this->worker_.join();
+}
+
+
+void MusicPlayer::play(const std::string &path, bool loop, float fadeSeconds) {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		this->requests_.push_back({ path, loop, static_cast<std::uint32_t>(std::max(0.0f, fadeSeconds) * this->sampleRate_) });
+	}
+	this->wake_.notify_one();
+}
+
+
+void MusicPlayer::stop(float fadeSeconds) {
+	this->play("", false, fadeSeconds);
+}
+
+
+void MusicPlayer::decode() {
+	std::vector<Request> requests;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		requests.swap(this->requests_);
+	}
+
+	for (const Request &r : requests) {
+		if (r.path.empty()) {
+			this->commands_.push({ nullptr, r.fadeFrames });
+			continue;
+		}
+		std::unique_ptr<StreamDecoder> decoder = openStreamDecoder(r.path);
+		if (!decoder) {
+			std::cerr << "ERROR: in " << __FILE__
+				<< " line " << __LINE__
+				<< ": cannot stream " << r.path << std::endl;
+			continue;
+		}
+		std::unique_ptr<Track> track(new Track());
+		track->decoder = std::move(decoder);
+		track->loop = r.loop;
+		track->chunk.resize(CHUNK_FRAMES * 2);
+		this->fill(*track);     // buffered before the audio thread sees it
+		if (!this->commands_.push({ track.get(), r.fadeFrames }))
+			continue;
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		this->tracks_.push_back(std::move(track));
+	}
+
+	// Only this thread adds or removes tracks, so walking them needs no lock
+	for (auto &track : this->tracks_)
+		if (!track->released.load(std::memory_order_acquire))
+			this->fill(*track);
+
+	std::lock_guard<std::mutex> lock(this->mutex_);
+	this->tracks_.erase(std::remove_if(this->tracks_.begin(), this->tracks_.end(),
+		[](const std::unique_ptr<Track> &t) { return t->released.load(std::memory_order_acquire); }), this->tracks_.end());
+}
+
+
+std::size_t MusicPlayer::fill(Track &track) {
+	double step = static_cast<double>(track.decoder->sampleRate()) / this->sampleRate_;
+	std::size_t added = 0;
+	while (!track.ended.load(std::memory_order_relaxed)) {
+		// Interpolate between source frames i and i + 1; i == -1 is the last frame of the previous chunk
+		while (track.phase + 1.0 >= static_cast<double>(track.chunkFrames)) {
+			if (!this->nextChunk(track)) {
+				track.ended.store(true, std::memory_order_release);
+				return added;
+			}
+		}
+		long i = static_cast<long>(std::floor(track.phase));
+		float t = static_cast<float>(track.phase - i);
+		const std::int16_t *a = i < 0 ? track.prev : &track.chunk[2 * i];
+		const std::int16_t *b = &track.chunk[2 * (i + 1)];
+		Frame f;
+		f.left = static_cast<std::int16_t>(std::lround(a[0] + (b[0] - a[0]) * t));
+		f.right = static_cast<std::int16_t>(std::lround(a[1] + (b[1] - a[1]) * t));
+		if (!track.ring.push(f))
+			break;
+		track.phase += step;
+		++added;
+	}
+	return added;
+}
+
+
+bool MusicPlayer::nextChunk(Track &track) {
+	if (track.chunkFrames > 0) {
+		track.prev[0] = track.chunk[2 * track.chunkFrames - 2];
+		track.prev[1] = track.chunk[2 * track.chunkFrames - 1];
+	}
+	track.phase -= static_cast<double>(track.chunkFrames);
+
+	track.chunkFrames = track.decoder->read(track.chunk.data(), CHUNK_FRAMES);
+	if (track.chunkFrames == 0 && track.loop && track.decoder->rewind()) {
+		// Straight on from the first frame: prev still holds the last one, so there is no gap
+		track.chunkFrames = track.decoder->read(track.chunk.data(), CHUNK_FRAMES);
+		this->loops_.fetch_add(1, std::memory_order_relaxed);
+	}
+	return track.chunkFrames > 0;
+}
+
+
+void MusicPlayer::mix(float *out, std::size_t frames) {
+	Command command;
+	while (this->commands_.pop(command)) {
+		// A third track during a crossfade cuts the oldest
+		if (this->fading_)
+			this->release(this->fading_);
+		this->fading_ = this->current_;
+		this->fadeOut_ = 0;
+		this->fadeOutLength_ = command.fadeFrames;
+		this->current_ = command.track;
+		this->fadeIn_ = 0;
+		this->fadeInLength_ = command.fadeFrames;
+	}
+
+	float gain = this->gain_.load(std::memory_order_relaxed);
+	if (this->current_ && !this->mixTrack(*this->current_, out, frames, gain, true))
+		this->release(this->current_);
+	if (this->fading_ && !this->mixTrack(*this->fading_, out, frames, gain, false))
+		this->release(this->fading_);
+}
+
+
+bool MusicPlayer::mixTrack(Track &track, float *out, std::size_t frames, float gain, bool fadeIn) {
+	std::uint32_t &done = fadeIn ? this->fadeIn_ : this->fadeOut_;
+	std::uint32_t length = fadeIn ? this->fadeInLength_ : this->fadeOutLength_;
+	for (std::size_t i = 0; i < frames; ++i) {
+		float fade = 1.0f;
+		if (done < length) {
+			float t = (done + 0.5f) / length;
+			fade = fadeIn ? t : 1.0f - t;
+			++done;
+		}
+		else if (!fadeIn) {
+			return false;     // faded out
+		}
+
+		Frame f;
+		if (!track.ring.pop(f)) {
+			if (track.ended.load(std::memory_order_acquire))
+				return false;
+			this->underruns_.fetch_add(frames - i, std::memory_order_relaxed);
+			return true;
+		}
+		out[2 * i] += f.left * gain * fade;
+		out[2 * i + 1] += f.right * gain * fade;
+	}
+	return true;
+}
+
+
+void MusicPlayer::release(Track *&track) {
+	track->released.store(true, std::memory_order_release);
+	track = nullptr;
+}
+
+
+std::size_t MusicPlayer::tracks() const {
+	std::lock_guard<std::mutex> lock(this->mutex_);
+	return this->tracks_.size();
+}
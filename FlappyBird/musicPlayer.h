@@ -0,0 +1,161 @@
+#ifndef MUSICPLAYER_H
+#define MUSICPLAYER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "audioMixer.h"
+#include "spscQueue.h"
+
+
+// Reads a compressed or uncompressed track piece by piece
+class StreamDecoder {
+public:
+	virtual ~StreamDecoder() = default;
+
+	virtual int sampleRate() const noexcept = 0;
+	// Decode up to frames stereo frames into out; 0 at the end of the track
+	virtual std::size_t read(std::int16_t *out, std::size_t frames) = 0;
+	// Back to the first frame; false when that fails
+	virtual bool rewind() = 0;
+};
+
+
+// 8 / 16 bit PCM RIFF/WAVE read straight from the file, mono is doubled
+class WavStreamDecoder : public StreamDecoder {
+public:
+	// False for a missing file or another format
+	bool open(const std::string &path);
+
+	int sampleRate() const noexcept override { return this->sampleRate_; }
+	std::size_t read(std::int16_t *out, std::size_t frames) override;
+	bool rewind() override;
+
+private:
+	std::ifstream file_;
+	int channels_ = 0;
+	int sampleRate_ = 0;
+	int bitsPerSample_ = 0;
+	std::streamoff dataStart_ = 0;
+	std::size_t dataFrames_ = 0;
+	std::size_t position_ = 0;
+	std::vector<std::uint8_t> bytes_;
+};
+
+
+// Decoder for the file type, null when the type is unsupported or the file cannot be opened
+std::unique_ptr<StreamDecoder> openStreamDecoder(const std::string &path);
+
+
+/*
+\  Background music streamed from disk instead of decoded whole. A worker
+\  thread decodes each track in CHUNK_FRAMES pieces into a RING_FRAMES lock-free
+\  ring (about 0.37 s, 64 KB), which the audio thread drains in mix(); memory
+\  per track stays under 100 KB however long it is. A looping track rewinds
+\  inside the same fill, so the loop point has no gap. play() while a track
+\  runs crossfades: the old one fades out as the new one fades in.
+\
+\  Only WAV is decoded for now; other formats plug in as a StreamDecoder.
+*/
+class MusicPlayer : public AudioSource {
+public:
+	static constexpr std::size_t RING_FRAMES = 16384;
+	static constexpr std::size_t CHUNK_FRAMES = 2048;
+
+	// worker false: no thread, the owner calls decode() (deterministic, for OfflineBackend)
+	explicit MusicPlayer(int sampleRate = AudioMixer::SAMPLE_RATE, bool worker = true);
+	~MusicPlayer() override;
+
+	MusicPlayer(const MusicPlayer &) = delete;
+	MusicPlayer(MusicPlayer &&) = delete;
+	MusicPlayer& operator=(const MusicPlayer &) = delete;
+	MusicPlayer& operator=(MusicPlayer &&) = delete;
+
+	// Game thread, never waits for the disk: the file is opened and buffered
+	// on the worker, then crossfaded in over fadeSeconds
+	void play(const std::string &path, bool loop = true, float fadeSeconds = 1.0f);
+	// Fade the current track out
+	void stop(float fadeSeconds = 1.0f);
+	void setGain(float gain) noexcept { this->gain_.store(gain, std::memory_order_relaxed); }
+
+	// Open requested tracks and top up every ring; the worker's loop body
+	void decode();
+
+	// Audio thread
+	void mix(float *out, std::size_t frames) override;
+
+	// Frames the audio thread wanted but the ring did not have yet
+	std::uint64_t underruns() const noexcept { return this->underruns_.load(std::memory_order_relaxed); }
+	// Times a looping track wrapped around
+	std::uint64_t loops() const noexcept { return this->loops_.load(std::memory_order_relaxed); }
+	std::size_t tracks() const;
+
+private:
+	struct Frame {
+		std::int16_t left;
+		std::int16_t right;
+	};
+
+	struct Track {
+		std::unique_ptr<StreamDecoder> decoder;
+		bool loop = false;
+		std::atomic<bool> ended{ false };      // decoder ran out, the ring holds the rest
+		std::atomic<bool> released{ false };   // the audio thread is done with it
+		SpscQueue<Frame, RING_FRAMES> ring;
+
+		// Linear resampling state (worker only)
+		std::vector<std::int16_t> chunk;
+		std::size_t chunkFrames = 0;
+		double phase = 0.0;                    // source position, -1 .. 0 is between prev and chunk[0]
+		std::int16_t prev[2] = {};
+	};
+
+	struct Request {
+		std::string path;
+		bool loop;
+		std::uint32_t fadeFrames;
+	};
+
+	struct Command {
+		Track *track;                          // null to fade out only
+		std::uint32_t fadeFrames;
+	};
+
+	// Fill one track's ring; returns the frames added
+	std::size_t fill(Track &track);
+	bool nextChunk(Track &track);
+	// Audio thread: add track to out; false once it is used up
+	bool mixTrack(Track &track, float *out, std::size_t frames, float gain, bool fadeIn);
+	void release(Track *&track);
+
+	int sampleRate_;
+	std::atomic<float> gain_{ 1.0f };
+
+	mutable std::mutex mutex_;                 // requests_ and tracks_
+	std::condition_variable wake_;
+	std::vector<Request> requests_;
+	std::vector<std::unique_ptr<Track>> tracks_;
+	bool stop_ = false;
+
+	// Worker -> audio thread
+	SpscQueue<Command, 16> commands_;
+
+	// Audio thread only
+	Track *current_ = nullptr;
+	Track *fading_ = nullptr;
+	std::uint32_t fadeIn_ = 0, fadeInLength_ = 0;     // frames done / total of current_'s fade in
+	std::uint32_t fadeOut_ = 0, fadeOutLength_ = 0;   // of fading_'s fade out
+
+	std::atomic<std::uint64_t> underruns_{ 0 };
+	std::atomic<std::uint64_t> loops_{ 0 };
+	std::thread worker_;                       // declared last, starts after the rest
+};
+
+#endif // !MUSICPLAYER_H
@@ -0,0 +1,106 @@
+#include "netProtocol.h"
+
+
+namespace net {
+
+	namespace {
+		void put8(std::vector<std::uint8_t> &out, std::uint8_t v) {
+			out.push_back(v);
+		}
+
+		void put16(std::vector<std::uint8_t> &out, std::uint16_t v) {
+			out.push_back(static_cast<std::uint8_t>(v));
+			out.push_back(static_cast<std::uint8_t>(v >> 8));
+		}
+
+		void put32(std::vector<std::uint8_t> &out, std::uint32_t v) {
+			put16(out, static_cast<std::uint16_t>(v));
+			put16(out, static_cast<std::uint16_t>(v >> 16));
+		}
+
+		std::uint16_t get16(const std::uint8_t *p) {
+			return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+		}
+
+		std::uint32_t get32(const std::uint8_t *p) {
+			return get16(p) | (static_cast<std::uint32_t>(get16(p + 2)) << 16);
+		}
+	}
+
+
+	void writeJoin(std::vector<std::uint8_t> &out, const Join &msg) {
+		put8(out, MSG_JOIN);
+		put32(out, msg.seed);
+		put8(out, msg.mode);
+	}
+
+
+	void writeInput(std::vector<std::uint8_t> &out, const Input &msg) {
+		put8(out, MSG_INPUT);
+		put32(out, msg.tick);
+		put8(out, msg.flap ? 1 : 0);
+	}
+
+
+	void writeAck(std::vector<std::uint8_t> &out, std::uint32_t tick) {
+		put8(out, MSG_ACK);
+		put32(out, tick);
+		put8(out, 0);
+	}
+
+
+	void writeSnapshot(std::vector<std::uint8_t> &out, const Snapshot &msg, const Snapshot *baseline) {
+		put8(out, MSG_SNAPSHOT);
+		put8(out, 0);
+		std::size_t sizeAt = out.size() - 1;
+		out[sizeAt] = static_cast<std::uint8_t>(SnapshotCodec::encode(msg, baseline, out));
+	}
+
+
+	long messageSize(const std::uint8_t *data, std::size_t size) {
+		if (size == 0)
+			return 0;
+		switch (data[0]) {
+		case MSG_JOIN:
+		case MSG_INPUT:
+		case MSG_ACK:
+			return CLIENT_MESSAGE_SIZE;
+		case MSG_SNAPSHOT:
+			if (size < SNAPSHOT_HEADER_SIZE)
+				return 0;
+			if (data[1] == 0 || data[1] > SnapshotCodec::MAX_SIZE)
+				return -1;
+			return static_cast<long>(SNAPSHOT_HEADER_SIZE + data[1]);
+		default:
+			return -1;
+		}
+	}
+
+
+	Join readJoin(const std::uint8_t *data) {
+		return { get32(data + 1), data[5] };
+	}
+
+
+	Input readInput(const std::uint8_t *data) {
+		return { get32(data + 1), data[5] != 0 };
+	}
+
+
+	std::uint32_t readAck(const std::uint8_t *data) {
+		return get32(data + 1);
+	}
+
+
+	bool readSnapshot(const std::uint8_t *data, SnapshotHistory &history, Snapshot &msg) {
+		const std::uint8_t *payload = data + SNAPSHOT_HEADER_SIZE;
+		std::size_t size = data[1];
+		if (SnapshotCodec::keyframe(payload, size))
+			history.clear();
+		if (!SnapshotCodec::decode(payload, size, history, msg))
+			return false;
+		history.put(msg);
+		return true;
+	}
+
+}
@@ -0,0 +1,62 @@
+#ifndef NETPROTOCOL_H
+#define NETPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "snapshotCodec.h"
+
+
+/*
+\  Wire format between the session host and its clients, little endian.
+\
+\  client -> host   Join      'J' seed:u32 mode:u8                     6 bytes
+\                   Input     'I' tick:u32 flap:u8                     6 bytes
+\                   Ack       'A' tick:u32 0:u8                        6 bytes
+\  host -> client   Snapshot  'S' size:u8 SnapshotCodec data      2 + size bytes
+\
+\  A snapshot is delta encoded against the newest tick the client acked,
+\  or sent as a keyframe when there is none.
+*/
+namespace net {
+
+	enum MessageType : std::uint8_t {
+		MSG_JOIN = 'J',
+		MSG_INPUT = 'I',
+		MSG_ACK = 'A',
+		MSG_SNAPSHOT = 'S'
+	};
+
+	constexpr std::size_t CLIENT_MESSAGE_SIZE = 6;
+	constexpr std::size_t SNAPSHOT_HEADER_SIZE = 2;
+
+	struct Join {
+		std::uint32_t seed;
+		std::uint8_t mode;
+	};
+
+	struct Input {
+		std::uint32_t tick;     // tick the flap belongs to
+		bool flap;
+	};
+
+	void writeJoin(std::vector<std::uint8_t> &out, const Join &msg);
+	void writeInput(std::vector<std::uint8_t> &out, const Input &msg);
+	void writeAck(std::vector<std::uint8_t> &out, std::uint32_t tick);
+	// baseline: snapshot the client acked, null for a keyframe
+	void writeSnapshot(std::vector<std::uint8_t> &out, const Snapshot &msg, const Snapshot *baseline);
+
+	// Bytes needed for the message starting at data, 0 when size is too short to tell.
+	// Returns -1 for an unknown message type or a bad size.
+	long messageSize(const std::uint8_t *data, std::size_t size);
+
+	// Parse one complete message of the given type; data points at the type byte
+	Join readJoin(const std::uint8_t *data);
+	Input readInput(const std::uint8_t *data);
+	std::uint32_t readAck(const std::uint8_t *data);
+	// Decodes against history and stores the result in it; false for bad data
+	bool readSnapshot(const std::uint8_t *data, SnapshotHistory &history, Snapshot &msg);
+
+}
+
+#endif // !NETPROTOCOL_H
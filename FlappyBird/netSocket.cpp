@@ -0,0 +1,266 @@
+#include <iostream>
+#include "netSocket.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+
+namespace net {
+
+	namespace {
+		bool wouldBlock() {
+#ifdef _WIN32
+			int e = WSAGetLastError();
+			return e == WSAEWOULDBLOCK || e == WSAEINPROGRESS;
+#else
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS;
+#endif
+		}
+
+		void prepare(Socket s) {
+#ifdef _WIN32
+			u_long on = 1;
+			ioctlsocket(s, FIONBIO, &on);
+#else
+			fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+			// Snapshots are small and latency bound
+			int one = 1;
+			setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+		}
+
+		sockaddr_in loopback(std::uint16_t port) {
+			sockaddr_in addr = {};
+			addr.sin_family = AF_INET;
+			addr.sin_port = htons(port);
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			return addr;
+		}
+
+		[[noreturn]] void fail(const char *what, int line) {
+			std::cerr << "ERROR: in " << __FILE__
+				<< " line " << line
+				<< ": " << what << " failed" << std::endl;
+			throw NetException();
+		}
+	}
+
+
+	void startUp() {
+#ifdef _WIN32
+		static bool done = false;
+		if (!done) {
+			WSADATA data;
+			if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+				fail("WSAStartup", __LINE__);
+			done = true;
+		}
+#else
+		std::signal(SIGPIPE, SIG_IGN);
+#endif
+	}
+
+
+	Socket listenLocal(std::uint16_t port, int backlog) {
+		Socket s = ::socket(AF_INET, SOCK_STREAM, 0);
+		if (s == INVALID)
+			fail("socket", __LINE__);
+
+		int one = 1;
+		setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+
+		sockaddr_in addr = loopback(port);
+		if (::bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(s, backlog) != 0) {
+			close(s);
+			fail("bind/listen", __LINE__);
+		}
+		prepare(s);
+		return s;
+	}
+
+
+	std::uint16_t localPort(Socket s) {
+		sockaddr_in addr = {};
+		socklen_t len = sizeof(addr);
+		getsockname(s, reinterpret_cast<sockaddr*>(&addr), &len);
+		return ntohs(addr.sin_port);
+	}
+
+
+	Socket connectLocal(std::uint16_t port) {
+		Socket s = ::socket(AF_INET, SOCK_STREAM, 0);
+		if (s == INVALID)
+			fail("socket", __LINE__);
+		prepare(s);
+
+		sockaddr_in addr = loopback(port);
+		if (::connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 && !wouldBlock()) {
+			close(s);
+			fail("connect", __LINE__);
+		}
+		return s;
+	}
+
+
+	Socket accept(Socket listener) {
+		Socket s = ::accept(listener, nullptr, nullptr);
+		if (s != INVALID)
+			prepare(s);
+		return s;
+	}
+
+
+	void close(Socket s) {
+#ifdef _WIN32
+		::closesocket(s);
+#else
+		::close(s);
+#endif
+	}
+
+
+	long send(Socket s, const void *data, std::size_t size) {
+#ifdef _WIN32
+		int n = ::send(s, static_cast<const char*>(data), static_cast<int>(size), 0);
+#else
+		long n = ::send(s, data, size, MSG_NOSIGNAL);
+#endif
+		if (n < 0)
+			return wouldBlock() ? 0 : -1;
+		return n;
+	}
+
+
+	long recv(Socket s, void *data, std::size_t size) {
+#ifdef _WIN32
+		int n = ::recv(s, static_cast<char*>(data), static_cast<int>(size), 0);
+#else
+		long n = ::recv(s, data, size, 0);
+#endif
+		if (n == 0)
+			return -1;
+		if (n < 0)
+			return wouldBlock() ? 0 : -1;
+		return n;
+	}
+
+
+#ifdef _WIN32
+
+	Poller::Poller() = default;
+	Poller::~Poller() = default;
+
+	void Poller::add(Socket s, std::uint64_t key, bool writable) {
+		this->entries_.push_back({ s, key, writable });
+	}
+
+	void Poller::modify(Socket s, std::uint64_t key, bool writable) {
+		for (auto &e : this->entries_) {
+			if (e.socket == s) {
+				e.key = key;
+				e.writable = writable;
+				return;
+			}
+		}
+	}
+
+	void Poller::remove(Socket s) {
+		for (std::size_t i = 0; i < this->entries_.size(); ++i) {
+			if (this->entries_[i].socket == s) {
+				// Swap with the last one, order does not matter
+				this->entries_[i] = this->entries_.back();
+				this->entries_.pop_back();
+				return;
+			}
+		}
+	}
+
+	std::size_t Poller::wait(int timeoutMs, std::vector<Event> &events) {
+		events.clear();
+		if (this->entries_.empty()) {
+			Sleep(timeoutMs < 0 ? 0 : timeoutMs);
+			return 0;
+		}
+
+		this->buffer_.resize(sizeof(WSAPOLLFD) * this->entries_.size());
+		WSAPOLLFD *fds = reinterpret_cast<WSAPOLLFD*>(this->buffer_.data());
+		for (std::size_t i = 0; i < this->entries_.size(); ++i) {
+			fds[i].fd = static_cast<SOCKET>(this->entries_[i].socket);
+			fds[i].events = POLLRDNORM | (this->entries_[i].writable ? POLLWRNORM : 0);
+			fds[i].revents = 0;
+		}
+		if (WSAPoll(fds, static_cast<ULONG>(this->entries_.size()), timeoutMs) <= 0)
+			return 0;
+
+		for (std::size_t i = 0; i < this->entries_.size(); ++i) {
+			SHORT r = fds[i].revents;
+			if (r)
+				events.push_back({ this->entries_[i].key, (r & (POLLRDNORM | POLLHUP)) != 0,
+					(r & POLLWRNORM) != 0, (r & (POLLERR | POLLNVAL)) != 0 });
+		}
+		return events.size();
+	}
+
+#else
+
+	namespace {
+		constexpr std::size_t MAX_EVENTS = 1024;
+	}
+
+	Poller::Poller()
+		: epoll_(epoll_create1(0)), buffer_(sizeof(epoll_event) * MAX_EVENTS)
+	{
+		if (this->epoll_ < 0)
+			fail("epoll_create1", __LINE__);
+	}
+
+	Poller::~Poller() {
+		::close(this->epoll_);
+	}
+
+	void Poller::add(Socket s, std::uint64_t key, bool writable) {
+		epoll_event ev = {};
+		ev.events = EPOLLIN | (writable ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+		ev.data.u64 = key;
+		if (epoll_ctl(this->epoll_, EPOLL_CTL_ADD, s, &ev) != 0)
+			fail("epoll_ctl", __LINE__);
+	}
+
+	void Poller::modify(Socket s, std::uint64_t key, bool writable) {
+		epoll_event ev = {};
+		ev.events = EPOLLIN | (writable ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+		ev.data.u64 = key;
+		epoll_ctl(this->epoll_, EPOLL_CTL_MOD, s, &ev);
+	}
+
+	void Poller::remove(Socket s) {
+		epoll_ctl(this->epoll_, EPOLL_CTL_DEL, s, nullptr);
+	}
+
+	std::size_t Poller::wait(int timeoutMs, std::vector<Event> &events) {
+		events.clear();
+		epoll_event *ev = reinterpret_cast<epoll_event*>(this->buffer_.data());
+		int n = epoll_wait(this->epoll_, ev, static_cast<int>(MAX_EVENTS), timeoutMs);
+		for (int i = 0; i < n; ++i) {
+			events.push_back({ ev[i].data.u64, (ev[i].events & (EPOLLIN | EPOLLHUP)) != 0,
+				(ev[i].events & EPOLLOUT) != 0, (ev[i].events & EPOLLERR) != 0 });
+		}
+		return events.size();
+	}
+
+#endif
+
+}
@@ -0,0 +1,88 @@
+#ifndef NETSOCKET_H
+#define NETSOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/*
+\  Thin non-blocking TCP layer shared by the session host and the load generator.
+\  Poller uses epoll on Linux and WSAPoll on Windows; both report readiness
+\  per socket with a user key, so callers never see the platform difference.
+*/
+namespace net {
+
+#ifdef _WIN32
+	// SOCKET, without pulling winsock2.h into every includer
+	using Socket = std::uintptr_t;
+	constexpr Socket INVALID = ~static_cast<Socket>(0);
+#else
+	using Socket = int;
+	constexpr Socket INVALID = -1;
+#endif
+
+	class NetException {};
+
+	// WSAStartup on Windows, ignore SIGPIPE elsewhere. Safe to call more than once.
+	void startUp();
+
+	// Non-blocking listening socket on 127.0.0.1:port (port 0 picks a free one)
+	Socket listenLocal(std::uint16_t port, int backlog = 1024);
+	std::uint16_t localPort(Socket s);
+
+	// Non-blocking connect to 127.0.0.1:port; completion is reported as writable
+	Socket connectLocal(std::uint16_t port);
+
+	// Non-blocking accept; INVALID when nothing is pending
+	Socket accept(Socket listener);
+
+	void close(Socket s);
+
+	// Bytes moved, 0 when the call would block, -1 on error or (recv) orderly close
+	long send(Socket s, const void *data, std::size_t size);
+	long recv(Socket s, void *data, std::size_t size);
+
+
+	class Poller {
+	public:
+		struct Event {
+			std::uint64_t key;
+			bool readable;
+			bool writable;
+			bool error;
+		};
+
+		Poller();
+		~Poller();
+
+		Poller(const Poller &) = delete;
+		Poller(Poller &&) = delete;
+		Poller& operator=(const Poller &) = delete;
+		Poller& operator=(Poller &&) = delete;
+
+		// Always watches readability; writability only when asked
+		void add(Socket s, std::uint64_t key, bool writable = false);
+		void modify(Socket s, std::uint64_t key, bool writable);
+		void remove(Socket s);
+
+		// Wait up to timeoutMs (-1 forever) and fill events; returns their number
+		std::size_t wait(int timeoutMs, std::vector<Event> &events);
+
+	private:
+#ifdef _WIN32
+		struct Entry {
+			Socket socket;
+			std::uint64_t key;
+			bool writable;
+		};
+		std::vector<Entry> entries_;
+#else
+		int epoll_;
+#endif
+		std::vector<char> buffer_;   // WSAPOLLFD or epoll_event array, kept opaque here
+	};
+
+}
+
+#endif // !NETSOCKET_H
@@ -0,0 +1,12 @@
+#version 430 core
+
+in vec2 TexCoord;
+
+out vec4 color;
+
+uniform sampler2D tex;
+
+void main()
+{
+	color = texture(tex, TexCoord);
+}
\ No newline at end of file
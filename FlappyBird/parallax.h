@@ -0,0 +1,144 @@
+#ifndef PARALLAX_H
+#define PARALLAX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "GL\glew.h"
+#include "glm\glm.hpp"
+#include "glm\gtc\type_ptr.hpp"
+#include "drawAble.h"
+#include "shader.h"
+#include "config.h"
+#include "textureCache.h"
+
+
+// A horizontal band of the background texture and how fast it scrolls.
+// top and bottom are texture rows, 0 = top of the image, 1 = bottom;
+// the band covers the same part of the screen.
+struct ParallaxLayer {
+	GLfloat top;
+	GLfloat bottom;
+	GLfloat speed;     // of the scrolling world, 1 moves with the tubes
+};
+
+
+/*
+\  Background of several layers (sky, clouds, city, ground) cut from one
+\  texture, each band tiled across the screen and scrolled at its own
+\  speed. All layers are one instanced draw of one quad: the band of a
+\  layer is an instance attribute, and its scroll is a texture offset
+\  wrapped to [0, 1) on the CPU, so the cost is the same however far the
+\  world has scrolled. Nearer layers get a slightly larger z than the ones
+\  behind them.
+*/
+class ParallaxBackground : public DrawAble {
+public:
+	static constexpr std::size_t MAX_LAYERS = 8;
+	// World width of one repeat of the texture, the view is 1000 wide
+	static constexpr GLfloat TILE = 1000.0f;
+
+	ParallaxBackground(TextureCache &textures, const char *tex, const std::vector<ParallaxLayer> &layers)
+		: layers_(layers.begin(), layers.begin() + std::min(layers.size(), MAX_LAYERS)), offsets_(layers_.size(), 0.0f) {
+		this->texture_ = textures.get(tex);
+		glBindTexture(GL_TEXTURE_2D, this->texture_);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// Unit quad, 0..1 in both directions
+		GLfloat quad[] = {
+			0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+			1.0f, 1.0f,  0.0f, 1.0f,  0.0f, 0.0f
+		};
+		std::vector<GLfloat> bands;
+		for (const ParallaxLayer &layer : this->layers_) {
+			bands.push_back(layer.top);
+			bands.push_back(layer.bottom);
+		}
+
+		glGenVertexArrays(1, &this->VAO_);
+		glBindVertexArray(this->VAO_);
+
+		glGenBuffers(2, this->VBO_);
+		glBindBuffer(GL_ARRAY_BUFFER, this->VBO_[0]);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), reinterpret_cast<GLvoid*>(0));
+		glEnableVertexAttribArray(0);
+
+		glBindBuffer(GL_ARRAY_BUFFER, this->VBO_[1]);
+		glBufferData(GL_ARRAY_BUFFER, bands.size() * sizeof(GLfloat), bands.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), reinterpret_cast<GLvoid*>(0));
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	ParallaxBackground(const ParallaxBackground &) = delete;
+	ParallaxBackground(ParallaxBackground &&) = delete;
+	ParallaxBackground &operator=(const ParallaxBackground &) = delete;
+	ParallaxBackground &operator=(ParallaxBackground &&) = delete;
+
+	~ParallaxBackground() {
+		glDeleteBuffers(2, this->VBO_);
+		glDeleteVertexArrays(1, &this->VAO_);
+	}
+
+	// How far the world has moved, in world units
+	void scroll(double distance) {
+		for (std::size_t i = 0; i < this->layers_.size(); ++i) {
+			double tiles = distance * this->layers_[i].speed / TILE;
+			this->offsets_[i] = static_cast<GLfloat>(tiles - std::floor(tiles));
+		}
+	}
+
+	void draw(Shader &shader) override {
+		shader.use();
+
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "projection"),
+			1, GL_FALSE, glm::value_ptr(PROJECTION));
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, this->texture_);
+		glUniform1i(glGetUniformLocation(shader.getProgram(), "tex"), 0);
+
+		RenderCommand command;
+		this->issue(shader, command);
+		glBindVertexArray(0);
+	}
+
+	void submit(RenderQueue &queue, Shader &shader, float z) override {
+		RenderCommand command;
+		command.shader = &shader;
+		command.program = shader.getProgram();
+		command.target = GL_TEXTURE_2D;
+		command.texture = this->texture_;
+		command.z = z;
+		command.source = this;
+		queue.push(command);
+	}
+
+	void issue(Shader &shader, const RenderCommand &command) override {
+		glUniform1fv(glGetUniformLocation(shader.getProgram(), "offsets"),
+			static_cast<GLsizei>(this->offsets_.size()), this->offsets_.data());
+		glUniform1f(glGetUniformLocation(shader.getProgram(), "z"), command.z);
+
+		glBindVertexArray(this->VAO_);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(this->layers_.size()));
+	}
+
+private:
+	std::vector<ParallaxLayer> layers_;
+	std::vector<GLfloat> offsets_;      // texture offset of each layer, in [0, 1)
+	GLuint texture_;
+	GLuint VAO_;
+	GLuint VBO_[2];
+};
+
+constexpr std::size_t ParallaxBackground::MAX_LAYERS;
+constexpr GLfloat ParallaxBackground::TILE;
+
+#endif // !PARALLAX_H
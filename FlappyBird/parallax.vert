@@ -0,0 +1,18 @@
+#version 430 core
+
+layout (location = 0) in vec2 corner;  // unit quad
+layout (location = 1) in vec2 band;    // per layer <top, bottom> texture rows
+
+uniform mat4 projection;
+uniform float offsets[8];               // scroll of each layer, in textures
+uniform float z;
+
+out vec2 TexCoord;
+
+void main()
+{
+	// The band covers the same rows of the 1000 x 1000 view as of the texture
+	float row = mix(band.y, band.x, corner.y);
+	gl_Position = projection * vec4(corner.x * 1000.0f - 500.0f, 500.0f - row * 1000.0f, z + 0.01f * gl_InstanceID, 1.0f);
+	TexCoord = vec2(corner.x + offsets[gl_InstanceID], row);
+}
\ No newline at end of file
@@ -12,6 +12,9 @@
 #include "drawAble.h"
 #include "shader.h"
 #include "config.h"
+#include "textureCache.h"
+#include "frameRing.h"
+#include "gameRules.h"
 
 
 // Represents a single particle and its state
@@ -27,11 +30,13 @@ struct Particle {
 // ParticleGenerator acts as a container for rendering a large number of 
 // particles by repeatedly spawning and updating particles and killing 
 // them after a given amount of time.
+// All alive particles are drawn with one instanced call; their offsets
+// and colors are written into the frame's part of a FrameRing.
 class ParticleGenerator : DrawAble
 {
 public:
     // Constructor
-    ParticleGenerator(GLuint amount = 500) {
+    ParticleGenerator(TextureCache &textures, FrameRing &ring, GLuint amount = 500) : ring_(ring) {
         // Set up mesh and attribute properties
         GLfloat particle_quad[] = {
             0.0f, 1.0f, 0.0f, 1.0f,
@@ -43,20 +48,7 @@ public:
             1.0f, 0.0f, 1.0f, 0.0f
         };
 
-        if (!this->textureLoaded_) {
-            glGenTextures(1, &this->texture_);
-            glBindTexture(GL_TEXTURE_2D, this->texture_);
-
-            int textureWidth, textureHeight;
-            unsigned char* image = SOIL_load_image("texture//particle.png", &textureWidth, &textureHeight, 0, SOIL_LOAD_RGBA);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            SOIL_free_image_data(image);
-            glBindTexture(GL_TEXTURE_2D, 0);
-
-            this->textureLoaded_ = true;
-        }
+        this->texture_ = textures.get("texture//particle.png");
 
         glGenVertexArrays(1, &this->VAO_);
         glBindVertexArray(this->VAO_);
@@ -70,6 +62,15 @@ public:
         // Set mesh attributes
         glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0);
         glEnableVertexAttribArray(0);
+        // Per particle <vec2 offset, vec4 color> from binding INSTANCES
+        glVertexAttribFormat(1, 2, GL_FLOAT, GL_FALSE, 0);
+        glVertexAttribBinding(1, INSTANCES);
+        glEnableVertexAttribArray(1);
+        glVertexAttribFormat(2, 4, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat));
+        glVertexAttribBinding(2, INSTANCES);
+        glEnableVertexAttribArray(2);
+        glVertexBindingDivisor(INSTANCES, 1);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
 
         // Create this->amount default particle instances
@@ -93,7 +94,7 @@ public:
             if (p.Life > 0.0f)
             {	// particle is alive, thus update
                 //p.Position -= p.Velocity * dt;
-                p.Position.x -= 2500 * dt;
+                p.Position.x += GameRules::TUBE_SPEED * dt;    // left behind as the world scrolls
                 p.Color.a -= dt * 7.5;
                 // cout << p.Color.a << endl;
             }
@@ -101,37 +102,84 @@ public:
     }
     // Render all particles
     void draw(Shader& shader) override {
+        if (this->write() == 0)
+            return;
         // Use additive blending to give it a 'glow' effect
         glBlendFunc(GL_SRC_ALPHA, GL_ONE);
         shader.use();
-        for (Particle particle : this->particles_)
-        {
-            if (particle.Life > 0.0f)
-            {
-                //cout << "particle: " << "posX: " << particle.Position.x << " posY: " << particle.Position.y << endl;
-                glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "projection"), 1, GL_FALSE, glm::value_ptr(PROJECTION));
-                glUniform2f(glGetUniformLocation(shader.getProgram(), "offset"), particle.Position.x, particle.Position.y);
-                glUniform4f(glGetUniformLocation(shader.getProgram(), "color"), particle.Color.r, particle.Color.g, particle.Color.b, particle.Color.a);
-                //cout << particle.Color.a << endl;
-                glBindTexture(GL_TEXTURE_2D, this->texture_);
-                glBindVertexArray(this->VAO_);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                glBindVertexArray(0);
-            }
-        }
+        glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "projection"), 1, GL_FALSE, glm::value_ptr(PROJECTION));
+        glBindTexture(GL_TEXTURE_2D, this->texture_);
+        this->issue(shader, RenderCommand());
+        glBindVertexArray(0);
         // Don't forget to reset to default blending mode
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
+    // Queue all particles as one additive draw of the blended pass
+    void submit(RenderQueue &queue, Shader &shader, float z) override {
+        if (this->write() == 0)
+            return;
+        RenderCommand command;
+        command.pass = RenderPass::Blended;
+        command.blend = BlendMode::Additive;
+        command.shader = &shader;
+        command.program = shader.getProgram();
+        command.target = GL_TEXTURE_2D;
+        command.texture = this->texture_;
+        command.z = z;
+        command.source = this;
+        queue.push(command);
+    }
+    // Particles drawn by the last submit or draw
+    GLsizei alive() const noexcept { return this->count_; }
+    void issue(Shader &shader, const RenderCommand &command) override {
+        glUniform1f(glGetUniformLocation(shader.getProgram(), "z"), command.z);
+        glBindVertexArray(this->VAO_);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, this->count_);
+    }
 private:
+    // Vertex buffer binding of the instance attributes, and floats per instance
+    static constexpr GLuint INSTANCES = 1;
+    static constexpr GLuint INSTANCE_FLOATS = 6;
+
     // State
+    FrameRing &ring_;
+    GLsizei count_ = 0;     // particles written by the last write()
     std::vector<Particle> particles_;
     GLuint amount_;
-    static GLuint texture_;
-    static bool textureLoaded_;
+    GLuint texture_;
     GLuint VAO_;
     // Stores the index of the last particle used (for quick access to next dead particle)
     GLuint lastUsedParticle_ = 0;
 
+    // Writes the alive particles into the frame ring and points the
+    // instance binding at them; returns how many there are
+    GLsizei write() {
+        this->count_ = 0;
+        FrameAllocation a = this->ring_.allocate<GLfloat>(INSTANCE_FLOATS * this->amount_);
+        if (!a)
+            return 0;
+        GLfloat *out = static_cast<GLfloat*>(a.data);
+        for (const Particle &particle : this->particles_)
+        {
+            if (particle.Life > 0.0f)
+            {
+                *out++ = particle.Position.x;
+                *out++ = particle.Position.y;
+                *out++ = particle.Color.r;
+                *out++ = particle.Color.g;
+                *out++ = particle.Color.b;
+                *out++ = particle.Color.a;
+                ++this->count_;
+            }
+        }
+        a.size = this->count_ * INSTANCE_FLOATS * sizeof(GLfloat);
+        this->ring_.commit(a);
+
+        glBindVertexArray(this->VAO_);
+        glBindVertexBuffer(INSTANCES, a.buffer, a.offset, INSTANCE_FLOATS * sizeof(GLfloat));
+        glBindVertexArray(0);
+        return this->count_;
+    }
     // Returns the first Particle index that's currently unused e.g. Life <= 0.0f or 0 if no particle is currently inactive
     GLuint firstUnusedParticle() {
         // First search from last used particle, this will usually return almost instantly
@@ -163,7 +211,7 @@ private:
     }
 };
 
-GLuint ParticleGenerator::texture_;
-bool ParticleGenerator::textureLoaded_ = false;
+constexpr GLuint ParticleGenerator::INSTANCES;
+constexpr GLuint ParticleGenerator::INSTANCE_FLOATS;
 
 #endif
\ No newline at end of file
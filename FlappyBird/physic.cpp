@@ -0,0 +1,6 @@
+#include "physic.h"
+
+
+const float utility::Motion::aUp = 160000.0f;
+const float utility::Motion::aDown = /*0.0001f;*/150000.0f;
+const float utility::Motion::vFlap = 5500.0f;
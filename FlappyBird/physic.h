@@ -21,6 +21,8 @@ namespace utility {
 
 		static const float aUp;
 		static const float aDown;
+		// Upward speed given by one flap
+		static const float vFlap;
 
 		Motion() = delete;
 		Motion(const Motion &) = delete;
@@ -31,10 +33,5 @@ namespace utility {
 	};
 }
 
-const float utility::Motion::aUp = 160000.0f;
-const float utility::Motion::aDown = /*0.0001f;*/150000.0f;
-
-
-
 #endif // !PHYSIC_H
 
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include "renderQueue.h"
+
+
+namespace {
+	// 0 nearest .. 0xFFFF farthest, for z in [-1, 1]
+	std::uint64_t depthBits(float z) {
+		float d = (1.0f - std::min(std::max(z, -1.0f), 1.0f)) * 0.5f;
+		return static_cast<std::uint64_t>(d * 65535.0f + 0.5f);
+	}
+}
+
+
+std::uint64_t RenderQueue::key(const RenderCommand &command) noexcept {
+	std::uint64_t program = command.program & 0xFFF;
+	std::uint64_t texture = command.texture & 0xFFFF;
+	std::uint64_t depth = depthBits(command.z);
+	if (command.pass == RenderPass::Opaque)
+		return program << 51 | texture << 35 | depth << 19;
+
+	std::uint64_t blend = command.blend == BlendMode::Additive ? 1 : 0;
+	return std::uint64_t{ 1 } << 63 | (0xFFFF - depth) << 47 | blend << 46 | program << 34 | texture << 18;
+}
+
+
+void RenderQueue::push(const RenderCommand &command) {
+	this->commands_.push_back(command);
+}
+
+
+const std::vector<const RenderCommand*> &RenderQueue::sort() {
+	std::size_t count = this->commands_.size();
+	this->sorted_.clear();
+	for (const RenderCommand &c : this->commands_)
+		this->sorted_.push_back(&c);
+	std::size_t unsorted = changes(this->sorted_);
+
+	this->entries_.resize(count);
+	this->scratch_.resize(count);
+	std::uint64_t all = 0, any = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		std::uint64_t k = key(this->commands_[i]);
+		this->entries_[i] = { k, static_cast<std::uint32_t>(i) };
+		all = i == 0 ? k : all & k;
+		any |= k;
+	}
+
+	// One counting pass per byte; bytes every key shares are skipped
+	for (int shift = 0; shift < 64; shift += 8) {
+		if (((all ^ any) >> shift & 0xFF) == 0)
+			continue;
+		std::size_t offsets[257] = {};
+		for (const Entry &e : this->entries_)
+			++offsets[(e.key >> shift & 0xFF) + 1];
+		for (int b = 0; b < 256; ++b)
+			offsets[b + 1] += offsets[b];
+		for (const Entry &e : this->entries_)
+			this->scratch_[offsets[e.key >> shift & 0xFF]++] = e;
+		this->entries_.swap(this->scratch_);
+	}
+
+	for (std::size_t i = 0; i < count; ++i)
+		this->sorted_[i] = &this->commands_[this->entries_[i].index];
+
+	++this->stats_.frames;
+	this->stats_.commands += count;
+	this->stats_.changes += changes(this->sorted_);
+	this->stats_.unsortedChanges += unsorted;
+	return this->sorted_;
+}
+
+
+void RenderQueue::clear() noexcept {
+	this->commands_.clear();
+	this->sorted_.clear();
+}
+
+
+std::size_t RenderQueue::changes(const std::vector<const RenderCommand*> &order) {
+	std::size_t n = 0;
+	const RenderCommand *last = nullptr;
+	for (const RenderCommand *c : order) {
+		if (!last || c->program != last->program)
+			++n;
+		if (c->texture && (!last || c->texture != last->texture))
+			++n;
+		if (last ? c->pass != last->pass || (c->pass == RenderPass::Blended && c->blend != last->blend) : c->pass == RenderPass::Blended)
+			++n;
+		last = c;
+	}
+	return n;
+}
+
+
+void RenderQueue::report(std::ostream &os) const {
+	if (this->stats_.frames == 0) {
+		os << "no frames" << std::endl;
+		return;
+	}
+	double frames = static_cast<double>(this->stats_.frames);
+	double sorted = this->stats_.changes / frames;
+	double unsorted = this->stats_.unsortedChanges / frames;
+	os << this->stats_.commands / frames << " draws, "
+		<< sorted << " state changes per frame ("
+		<< unsorted << " unsorted, " << unsorted - sorted << " saved) over "
+		<< this->stats_.frames << " frames" << std::endl;
+}
@@ -0,0 +1,102 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+
+class Shader;
+class DrawAble;
+
+
+enum class RenderPass : std::uint8_t { Opaque, Blended };
+enum class BlendMode : std::uint8_t { Alpha, Additive };
+
+
+// World z of each layer. PROJECTION looks down -z, so a larger z is nearer;
+// every layer has its own z so the depth test, not the draw order, decides
+// what is in front.
+namespace RenderLayer {
+	constexpr float Ui = 0.5f;
+	constexpr float Bird = 0.4f;
+	constexpr float Effects = 0.3f;     // ghosts, particles
+	constexpr float Tubes = 0.2f;
+	constexpr float Background = -0.5f;
+}
+
+
+// One draw: the state it needs and the object that issues it
+struct RenderCommand {
+	RenderPass pass = RenderPass::Opaque;
+	BlendMode blend = BlendMode::Alpha;     // blended pass only
+	Shader *shader = nullptr;
+	unsigned program = 0;                   // shader's GL program, part of the sort key
+	unsigned target = 0;                    // texture target and name, 0 for none
+	unsigned texture = 0;
+	float z = 0.0f;
+	DrawAble *source = nullptr;             // issue(shader, command) draws it
+	std::uint32_t part = 0;                 // which of the source's draws, for sources with several
+};
+
+
+// Per-frame averages since the last clearStats()
+struct RenderStats {
+	std::size_t frames = 0;
+	std::size_t commands = 0;
+	std::size_t changes = 0;           // program, texture and blend switches, sorted
+	std::size_t unsortedChanges = 0;   // the same in submission order
+};
+
+
+/*
+\  Draws of a frame collected from every DrawAble, then sorted by a 64 bit
+\  key so the renderer switches as little state as possible:
+\    opaque  [pass | program | texture | depth front to back]
+\    blended [pass | depth back to front | blend | program | texture]
+\  Opaque draws come first, grouped by program and texture; within a group
+\  the nearest is drawn first so the depth test rejects hidden pixels early.
+\  Blended draws follow, farthest first, with depth writes off. The sort is
+\  an LSD radix sort over the key bytes that differ; it is stable, so equal
+\  keys keep the order they were submitted in.
+*/
+class RenderQueue {
+public:
+	RenderQueue() = default;
+
+	RenderQueue(const RenderQueue &) = delete;
+	RenderQueue(RenderQueue &&) = delete;
+	RenderQueue& operator=(const RenderQueue &) = delete;
+	RenderQueue& operator=(RenderQueue &&) = delete;
+
+	static std::uint64_t key(const RenderCommand &command) noexcept;
+
+	void push(const RenderCommand &command);
+	// Sort the frame's commands and count the state changes saved
+	const std::vector<const RenderCommand*> &sort();
+	// Forget the frame's commands
+	void clear() noexcept;
+
+	std::size_t size() const noexcept { return this->commands_.size(); }
+
+	const RenderStats &stats() const noexcept { return this->stats_; }
+	void report(std::ostream &os) const;
+	void clearStats() noexcept { this->stats_ = RenderStats(); }
+
+	// State switches drawing commands in the given order costs
+	static std::size_t changes(const std::vector<const RenderCommand*> &order);
+
+private:
+	struct Entry {
+		std::uint64_t key;
+		std::uint32_t index;
+	};
+
+	std::vector<RenderCommand> commands_;
+	std::vector<Entry> entries_, scratch_;
+	std::vector<const RenderCommand*> sorted_;
+	RenderStats stats_;
+};
+
+#endif // !RENDERQUEUE_H
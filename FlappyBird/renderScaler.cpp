@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "renderScaler.h"
+
+
+constexpr float RenderScaler::STEP;
+
+
+Viewport letterbox(int windowWidth, int windowHeight, int virtualWidth, int virtualHeight) noexcept {
+	if (windowWidth <= 0 || windowHeight <= 0 || virtualWidth <= 0 || virtualHeight <= 0)
+		return { 0, 0, std::max(windowWidth, 0), std::max(windowHeight, 0) };
+
+	// Fit by width unless that is too tall, in 64 bit so large windows cannot overflow
+	long long width = windowWidth;
+	long long height = width * virtualHeight / virtualWidth;
+	if (height > windowHeight) {
+		height = windowHeight;
+		width = height * virtualWidth / virtualHeight;
+	}
+	return { static_cast<int>((windowWidth - width) / 2), static_cast<int>((windowHeight - height) / 2),
+		static_cast<int>(width), static_cast<int>(height) };
+}
+
+
+DisplayConfig DisplayConfig::parse(int argc, char **argv) {
+	DisplayConfig config;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--latency") == 0) {
+			config.measureLatency = true;
+			continue;
+		}
+		if (std::strcmp(argv[i], "--stats") == 0) {
+			config.stats = true;
+			continue;
+		}
+		if (i + 1 == argc)
+			break;
+		const char *value = argv[i + 1];
+		if (std::strcmp(argv[i], "--vsync") == 0)
+			config.vsync = std::atoi(value) != 0;
+		else if (std::strcmp(argv[i], "--fps") == 0)
+			config.fpsCap = std::max(0, std::atoi(value));
+		else if (std::strcmp(argv[i], "--scale") == 0) {
+			config.fixedScale = std::min(1.0f, std::max(0.1f, static_cast<float>(std::atof(value))));
+			config.dynamicResolution = false;
+		}
+		else if (std::strcmp(argv[i], "--min-scale") == 0)
+			config.minScale = std::min(1.0f, std::max(0.1f, static_cast<float>(std::atof(value))));
+		else
+			continue;
+		++i;
+	}
+	return config;
+}
+
+
+RenderScaler::RenderScaler(double budgetMs, float minScale, int window)
+	: budgetMs_(budgetMs), minScale_(minScale), window_(std::max(window, 1)) {}
+
+
+bool RenderScaler::frame(double ms) {
+	this->total_ += ms;
+	if (++this->frames_ < this->window_)
+		return false;
+
+	double average = this->total_ / this->frames_;
+	this->total_ = 0.0;
+	this->frames_ = 0;
+
+	float scale = this->scale_;
+	if (average > this->budgetMs_) {
+		// Where cost ~ scale^2 would meet 90% of the budget, down to the step grid
+		float fit = this->scale_ * static_cast<float>(std::sqrt(0.9 * this->budgetMs_ / average));
+		scale = std::floor(fit / STEP) * STEP;
+		scale = std::max(this->minScale_, std::min(scale, this->scale_ - STEP));
+	}
+	else if (this->scale_ < 1.0f) {
+		float up = std::min(1.0f, this->scale_ + STEP);
+		double ratio = static_cast<double>(up) / this->scale_;
+		if (average * ratio * ratio < 0.9 * this->budgetMs_)
+			scale = up;
+	}
+
+	scale = std::max(this->minScale_, scale);
+	if (scale == this->scale_)
+		return false;
+	this->scale_ = scale;
+	return true;
+}
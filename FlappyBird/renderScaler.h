@@ -0,0 +1,62 @@
+#ifndef RENDERSCALER_H
+#define RENDERSCALER_H
+
+
+// Rectangle of the window in pixels, origin bottom left like glViewport
+struct Viewport {
+	int x, y, width, height;
+};
+
+
+// Largest rectangle of the virtual aspect ratio centred in the window;
+// the rest of the window becomes black bars
+Viewport letterbox(int windowWidth, int windowHeight, int virtualWidth, int virtualHeight) noexcept;
+
+
+// Presentation settings, from the command line
+struct DisplayConfig {
+	bool vsync = true;
+	int fpsCap = 0;                    // frames per second; 0 leaves it to vsync, or 60 without vsync
+	bool dynamicResolution = true;
+	float minScale = 0.5f;             // lowest render scale dynamic resolution may pick
+	float fixedScale = 1.0f;           // render scale without dynamic resolution
+	double budgetMs = 1000.0 / 60.0;   // GPU time per frame dynamic resolution aims for
+	bool measureLatency = false;       // report input-to-photon estimates
+	bool stats = false;                // print frame pacing and render statistics
+
+	// Reads --vsync 0|1, --fps N, --scale S (fixed scale, turns dynamic
+	// resolution off), --min-scale S, --latency and --stats; other arguments
+	// are left alone
+	static DisplayConfig parse(int argc, char **argv);
+};
+
+
+/*
+\  Dynamic resolution: picks the render scale (fraction of the viewport's
+\  width and height) from measured frame times. Fill cost grows with the
+\  square of the scale, so an expensive window of frames drops straight to
+\  the scale that should fit the budget, while a cheap one only steps up
+\  when the larger scale is predicted to fit with 10% to spare. Changes
+\  are at least one window of frames apart, so the scale does not flicker.
+*/
+class RenderScaler {
+public:
+	static constexpr float STEP = 0.125f;
+
+	explicit RenderScaler(double budgetMs = 1000.0 / 60.0, float minScale = 0.5f, int window = 30);
+
+	// Time of one frame's resolution-dependent work; true when scale() changed
+	bool frame(double ms);
+
+	float scale() const noexcept { return this->scale_; }
+
+private:
+	double budgetMs_;
+	float minScale_;
+	int window_;
+	float scale_ = 1.0f;
+	double total_ = 0.0;
+	int frames_ = 0;
+};
+
+#endif // !RENDERSCALER_H
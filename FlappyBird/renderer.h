@@ -0,0 +1,74 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include "GL\glew.h"
+#include "glm\glm.hpp"
+#include "glm\gtc\type_ptr.hpp"
+#include "drawAble.h"
+#include "renderQueue.h"
+#include "shader.h"
+#include "config.h"
+
+
+/*
+\  Draws a sorted RenderQueue, switching program, texture and blend state
+\  only where the next command needs something else. The projection is set
+\  once per program switch; samplers keep their default unit 0.
+*/
+class Renderer {
+public:
+	Renderer() = default;
+
+	Renderer(const Renderer &) = delete;
+	Renderer(Renderer &&) = delete;
+	Renderer &operator=(const Renderer &) = delete;
+	Renderer &operator=(Renderer &&) = delete;
+
+	// Draw and empty the queue
+	void flush(RenderQueue &queue) {
+		unsigned program = 0, texture = 0;
+		bool blended = false;
+		BlendMode blend = BlendMode::Alpha;
+		glActiveTexture(GL_TEXTURE0);
+		for (const RenderCommand *c : queue.sort()) {
+			if (c->program != program) {
+				c->shader->use();
+				glUniformMatrix4fv(glGetUniformLocation(c->program, "projection"),
+					1, GL_FALSE, glm::value_ptr(PROJECTION));
+				program = c->program;
+			}
+			if (c->texture && c->texture != texture) {
+				glBindTexture(c->target, c->texture);
+				texture = c->texture;
+			}
+
+			if (c->pass == RenderPass::Blended && !blended) {
+				// Blended draws test against the opaque ones but do not hide each other
+				glEnable(GL_BLEND);
+				glDepthMask(GL_FALSE);
+				glBlendFunc(GL_SRC_ALPHA, c->blend == BlendMode::Additive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+				blended = true;
+				blend = c->blend;
+			}
+			else if (c->pass == RenderPass::Blended && c->blend != blend) {
+				glBlendFunc(GL_SRC_ALPHA, c->blend == BlendMode::Additive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+				blend = c->blend;
+			}
+
+			c->source->issue(*c->shader, *c);
+			// A command without a texture draws itself whole and may bind its own
+			if (!c->texture)
+				texture = 0;
+		}
+
+		glBindVertexArray(0);
+		if (blended) {
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			glDepthMask(GL_TRUE);
+			glDisable(GL_BLEND);
+		}
+		queue.clear();
+	}
+};
+
+#endif // !RENDERER_H
@@ -0,0 +1,61 @@
+#include "scene.h"
+
+
+void SceneStack::push(Scene &scene) {
+	this->scenes_.push_back(&scene);
+	this->entered();
+}
+
+
+void SceneStack::pop() {
+	if (this->scenes_.empty())
+		return;
+	this->scenes_.pop_back();
+	this->entered();
+}
+
+
+void SceneStack::replace(Scene &scene) {
+	if (!this->scenes_.empty())
+		this->scenes_.pop_back();
+	this->push(scene);
+}
+
+
+void SceneStack::entered() {
+	if (Scene *scene = this->top())
+		scene->enter();
+}
+
+
+void SceneStack::update(float deltaTime) {
+	if (Scene *scene = this->top())
+		scene->update(deltaTime);
+}
+
+
+void SceneStack::draw() {
+	for (std::size_t i = this->scenes_.size(); i-- > 0;) {
+		this->scenes_[i]->draw();
+		if (!this->scenes_[i]->overlay())
+			break;
+	}
+}
+
+
+void SceneStack::keyDown(unsigned char key) {
+	if (Scene *scene = this->top())
+		scene->keyDown(key);
+}
+
+
+void SceneStack::mouseDown(int x, int y) {
+	if (Scene *scene = this->top())
+		scene->mouseDown(x, y);
+}
+
+
+void SceneStack::mouseUp(int x, int y) {
+	if (Scene *scene = this->top())
+		scene->mouseUp(x, y);
+}
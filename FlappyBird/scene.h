@@ -0,0 +1,72 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <cstddef>
+#include <vector>
+
+
+// One screen of the game: owns its widgets, draws them and handles their input
+class Scene {
+public:
+	virtual ~Scene() = default;
+
+	// Just became the top of the stack
+	virtual void enter() {}
+	// Only the top scene is updated
+	virtual void update(float) {}
+	virtual void draw() {}
+	virtual void keyDown(unsigned char) {}
+	virtual void mouseDown(int, int) {}
+	virtual void mouseUp(int, int) {}
+
+	// An overlay lets the scene under it be drawn (but not updated), e.g. pause
+	virtual bool overlay() const noexcept { return false; }
+	// Changes without input, so it needs a new frame all the time. Other
+	// scenes are only redrawn after input, and the loop sleeps in between.
+	virtual bool animated() const noexcept { return false; }
+};
+
+
+/*
+\  Stack of active scenes. Input and update go to the top scene only, so a
+\  frame or a click never touches the widgets of hidden screens. draw()
+\  starts at the top and goes down through overlays to the first opaque
+\  scene; scenes submit into a RenderQueue, which decides the draw order.
+\
+\  Scenes are not owned; the caller keeps them alive for as long as they
+\  are on the stack. Changes take effect at once, and enter() is called on
+\  the new top.
+*/
+class SceneStack {
+public:
+	SceneStack() = default;
+
+	SceneStack(const SceneStack &) = delete;
+	SceneStack(SceneStack &&) = delete;
+	SceneStack& operator=(const SceneStack &) = delete;
+	SceneStack& operator=(SceneStack &&) = delete;
+
+	void push(Scene &scene);
+	void pop();
+	// Pop the top and push scene in its place
+	void replace(Scene &scene);
+
+	// Null when empty
+	Scene *top() const noexcept { return this->scenes_.empty() ? nullptr : this->scenes_.back(); }
+	// Whether the top scene is animated
+	bool animated() const noexcept { return this->top() && this->top()->animated(); }
+	std::size_t size() const noexcept { return this->scenes_.size(); }
+
+	void update(float deltaTime);
+	void draw();
+	void keyDown(unsigned char key);
+	void mouseDown(int x, int y);
+	void mouseUp(int x, int y);
+
+private:
+	void entered();
+
+	std::vector<Scene*> scenes_;
+};
+
+#endif // !SCENE_H
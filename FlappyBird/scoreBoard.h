@@ -1,104 +1,72 @@
 #ifndef SCOREBOARD_H
 #define SCOREBOARD_H
 
-#include<array>
+#include <string>
 #include <vector>
-#include "displayBoard.h"
+#include "board.h"
 #include "drawAble.h"
+#include "textRenderer.h"
 
-// չʾչ
+std::vector<const char*> score_tex = {
+						"texture//0.png", "texture//1.png", "texture//2.png", "texture//3.png",
+						"texture//4.png", "texture//5.png", "texture//6.png",
+						"texture//7.png", "texture//8.png", "texture//9.png",
+						"texture//empty.png", "texture//pause.png"
+};
+
+// չʾչ, λ
+// The digits are glyphs of a TextRenderer, so any score is one draw call
 class ScoreBoard : public DrawAble {
 public:
-	ScoreBoard(const glm::vec3 pos = { 0.0f, 0.0f, 0.0f }, 
+	ScoreBoard(TextureCache &textures, FrameRing &ring,
+		const glm::vec3 pos = { 0.0f, 0.0f, 0.0f }, 
 		const glm::vec3 scale = { 1.0f, 1.0f, 1.0f }, 
 		const int val = 0,
-		const std::vector<const char*> &texs = {"texture//0.png", "texture//1.png", "texture//2.png", "texture//3.png",
-												"texture//4.png", "texture//5.png", "texture//6.png", 
-												"texture//7.png", "texture//8.png", "texture//9.png", 
-												"texture//empty.png", "texture//pause.png"})
-		: boards_{ DisplayBoard(texs, {pos.x + 2 * BoardSp::HALFEDGE * scale.x, pos.y, pos.z}, scale),
-				   DisplayBoard(texs, pos, scale),
-				   DisplayBoard(texs, {pos.x - 2 * BoardSp::HALFEDGE * scale.x, pos.y, pos.z}, scale) },
-		value_(val) 
+		const std::vector<const char*> &texs = score_tex)
+		: digits_(textures, ring, texs, 2 * BoardSp::HALFEDGE * scale.x, 2 * BoardSp::HALFEDGE * scale.y, 2 * BoardSp::HALFEDGE * scale.x),
+		pos_(pos), scale_(scale), value_(val)
 	{
-		this->setRun();
-		if (value_ < 10) {
-			boards_[Right].setTexture(value_);
-			boards_[Middle].setTexture(EmptyIndex);
-			boards_[Left].setTexture(EmptyIndex);
-		}
-		else if (value_ < 100) {
-			boards_[Right].setTexture(value_ % 10);
-			boards_[Middle].setTexture(value_ / 10);
-			boards_[Left].setTexture(EmptyIndex);
-		}
-		else if (value_ < 1000) {
-			boards_[Right].setTexture(value_ % 10);
-			boards_[Middle].setTexture(value_ / 10 % 10);
-			boards_[Left].setTexture(value_ % 100);
-		}
-		else
-			return;
+		this->digits_.font().map("0123456789", 0);
+		this->digits_.font().map(Pause, PauseIndex);
 	}
 
 	void draw(Shader &shader) override {
-		boards_[Right].draw(shader);
-		boards_[Middle].draw(shader);
-		boards_[Left].draw(shader);
+		this->layout();
+		this->digits_.draw(shader);
 	}
 
-	void setValue(const int val) {
-		value_ = val;
-
-		if (paused_) {
-			boards_[Right].setTexture(EmptyIndex);
-			boards_[Middle].setTexture(PauseIndex);
-			boards_[Left].setTexture(EmptyIndex);
-		}
-		else {
-			if (value_ < 10) {
-				boards_[Right].setTexture(value_);
-				boards_[Middle].setTexture(EmptyIndex);
-				boards_[Left].setTexture(EmptyIndex);
-			}
-			else if (value_ < 100) {
-				boards_[Right].setTexture(value_ % 10);
-				boards_[Middle].setTexture(value_ / 10);
-				boards_[Left].setTexture(EmptyIndex);
-			}
-			else if (value_ < 1000) {
-				boards_[Right].setTexture(value_ % 10);
-				boards_[Middle].setTexture(value_ / 10 % 10);
-				boards_[Left].setTexture(value_ / 100);
-			}
-			else
-				return;
-		}
+	void submit(RenderQueue &queue, Shader &shader, float z) override {
+		this->layout();
+		this->digits_.submit(queue, shader, z);
 	}
 
+	void setValue(const int val) { value_ = val; }
+
 	int getValue() const noexcept { return this->value_; }
 
-	void setPause() { 
-		this->paused_ = true;
-		this->setValue(this->value_);
-	}
+	void setPause() { this->paused_ = true; }
 
-	void setRun() { 
-		this->paused_ = false;
-		this->setValue(this->value_);
-	}
+	void setRun() { this->paused_ = false; }
 
 private:
-	const static size_t EmptyIndex;
-	const static size_t PauseIndex;
-	enum {Right = 0, Middle = 1, Left = 2};
+	// ͣʱֻʾͣͼ
+	void layout() {
+		std::string text = this->paused_ ? std::string(1, Pause) : std::to_string(this->value_);
+		this->digits_.text(text, { this->pos_.x, this->pos_.y - BoardSp::HALFEDGE * this->scale_.y }, 1.0f, BitmapFont::Center);
+	}
+
+	// Character of the pause glyph in the digit font
+	static constexpr char Pause = 'P';
+	static constexpr int PauseIndex = 11;
+	TextRenderer digits_;
+	glm::vec3 pos_;
+	glm::vec3 scale_;
 	int value_;
 	bool paused_ = false;
-	std::array<DisplayBoard, 3> boards_;
 };
 
 
-const size_t ScoreBoard::EmptyIndex = 10;
-const size_t ScoreBoard::PauseIndex = 11;
+constexpr char ScoreBoard::Pause;
+constexpr int ScoreBoard::PauseIndex;
 
 #endif // !SCOREBOARD_H
@@ -0,0 +1,241 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <chrono>
+#include <iostream>
+#include "GL\glew.h"
+#include "GL\freeglut.h"
+#include "renderScaler.h"
+#include "framePacer.h"
+
+#ifdef _WIN32
+#include "GL\wglew.h"
+#endif
+
+
+// GPU time of whole frames, read a few frames late so nothing ever waits on the GPU
+class GpuTimer {
+public:
+	GpuTimer() = default;
+
+	GpuTimer(const GpuTimer &) = delete;
+	GpuTimer(GpuTimer &&) = delete;
+	GpuTimer &operator=(const GpuTimer &) = delete;
+	GpuTimer &operator=(GpuTimer &&) = delete;
+
+	~GpuTimer() {
+		if (this->queries_[0])
+			glDeleteQueries(SLOTS, this->queries_);
+	}
+
+	void begin() {
+		if (!this->queries_[0])
+			glGenQueries(SLOTS, this->queries_);
+		// All slots still in flight: leave this frame untimed rather than wait
+		this->timing_ = this->issued_ - this->read_ < SLOTS;
+		if (this->timing_)
+			glBeginQuery(GL_TIME_ELAPSED, this->queries_[this->issued_ % SLOTS]);
+	}
+
+	void end() {
+		if (!this->timing_)
+			return;
+		glEndQuery(GL_TIME_ELAPSED);
+		++this->issued_;
+	}
+
+	// Milliseconds of the oldest frame the GPU has finished, or -1 when none has
+	double poll() {
+		if (this->read_ == this->issued_)
+			return -1.0;
+		GLuint query = this->queries_[this->read_ % SLOTS];
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return -1.0;
+		GLuint64 ns = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+		++this->read_;
+		return ns / 1.0e6;
+	}
+
+private:
+	static constexpr GLsizei SLOTS = 4;
+
+	GLuint queries_[SLOTS] = {};
+	unsigned issued_ = 0;
+	unsigned read_ = 0;
+	bool timing_ = false;
+};
+
+
+/*
+\  The window's output: a letterboxed viewport of the virtual resolution,
+\  dynamic render scale, vsync and a frame cap.
+\  Below scale 1 a frame is drawn into an offscreen colour + depth buffer
+\  of the scaled size and stretched into the viewport with a linear blit;
+\  at scale 1 it is drawn straight into the window, scissored to the
+\  viewport. The scale follows the GPU time of past frames, see RenderScaler.
+\  Frames are held to the cap by a FramePacer; without a cap vsync paces
+\  them, or 60 fps when swap control is unavailable or turned off.
+*/
+class Screen {
+public:
+	Screen(const DisplayConfig &config, int virtualWidth, int virtualHeight)
+		: config_(config), virtualWidth_(virtualWidth), virtualHeight_(virtualHeight),
+		scaler_(config.budgetMs, config.minScale) {
+		bool synced = false;
+#ifdef _WIN32
+		// Swap control is a WGL extension; elsewhere the driver default stays
+		if (WGLEW_EXT_swap_control) {
+			wglSwapIntervalEXT(config.vsync ? 1 : 0);
+			synced = config.vsync;
+		}
+#endif
+		this->pacer_.setTarget(config.fpsCap > 0 ? 1000.0 / config.fpsCap : synced ? 0.0 : 1000.0 / 60.0);
+	}
+
+	Screen(const Screen &) = delete;
+	Screen(Screen &&) = delete;
+	Screen &operator=(const Screen &) = delete;
+	Screen &operator=(Screen &&) = delete;
+
+	~Screen() {
+		this->release();
+	}
+
+	// Window resized
+	void resize(int width, int height) {
+		this->windowWidth_ = width;
+		this->windowHeight_ = height;
+		this->viewport_ = letterbox(width, height, this->virtualWidth_, this->virtualHeight_);
+	}
+
+	// Start a frame: afterwards draws land in the viewport, at the current scale
+	void begin() {
+		this->started_ = std::chrono::steady_clock::now();
+		this->timer_.begin();
+
+		// Black bars
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDisable(GL_SCISSOR_TEST);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		const Viewport &v = this->viewport_;
+		this->offscreen_ = this->scale() < 1.0f && this->target(static_cast<int>(v.width * this->scale() + 0.5f), static_cast<int>(v.height * this->scale() + 0.5f));
+		if (this->offscreen_) {
+			glBindFramebuffer(GL_FRAMEBUFFER, this->fbo_);
+			glViewport(0, 0, this->width_, this->height_);
+		}
+		else {
+			glViewport(v.x, v.y, v.width, v.height);
+			glScissor(v.x, v.y, v.width, v.height);
+			glEnable(GL_SCISSOR_TEST);
+		}
+	}
+
+	// Finish a frame: upscale, present, adjust the scale, wait for the next frame's turn
+	void end() {
+		const Viewport &v = this->viewport_;
+		if (this->offscreen_) {
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, this->fbo_);
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+			glBlitFramebuffer(0, 0, this->width_, this->height_, v.x, v.y, v.x + v.width, v.y + v.height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		}
+		glDisable(GL_SCISSOR_TEST);
+		this->timer_.end();
+
+		// CPU time of the frame is the fallback where timer queries never answer
+		double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->started_).count();
+		glutSwapBuffers();
+
+		if (this->config_.dynamicResolution) {
+			double gpuMs = this->timer_.poll();
+			if (gpuMs >= 0.0)
+				this->timed_ = true;
+			if (gpuMs >= 0.0 || !this->timed_) {
+				if (this->scaler_.frame(gpuMs >= 0.0 ? gpuMs : cpuMs) && this->config_.stats)
+					std::cout << "render scale " << this->scaler_.scale() << std::endl;
+			}
+		}
+
+		this->pacer_.wait();
+	}
+
+	float scale() const noexcept { return this->config_.dynamicResolution ? this->scaler_.scale() : this->config_.fixedScale; }
+	const Viewport &viewport() const noexcept { return this->viewport_; }
+	int windowWidth() const noexcept { return this->windowWidth_; }
+	int windowHeight() const noexcept { return this->windowHeight_; }
+	FramePacer &pacer() noexcept { return this->pacer_; }
+	const DisplayConfig &config() const noexcept { return this->config_; }
+
+private:
+	// Offscreen buffers of width x height; false if the driver refuses them
+	bool target(int width, int height) {
+		if (width <= 0 || height <= 0)
+			return false;
+		if (this->fbo_ && width == this->width_ && height == this->height_)
+			return true;
+
+		this->release();
+		glGenFramebuffers(1, &this->fbo_);
+		glBindFramebuffer(GL_FRAMEBUFFER, this->fbo_);
+
+		glGenRenderbuffers(1, &this->color_);
+		glBindRenderbuffer(GL_RENDERBUFFER, this->color_);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->color_);
+
+		glGenRenderbuffers(1, &this->depth_);
+		glBindRenderbuffer(GL_RENDERBUFFER, this->depth_);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, this->depth_);
+
+		bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		if (!complete) {
+			std::cerr << "ERROR: in " << __FILE__
+				<< " line " << __LINE__
+				<< ": offscreen buffer " << width << "x" << height << " incomplete, rendering at full scale" << std::endl;
+			this->release();
+			this->config_.dynamicResolution = false;
+			this->config_.fixedScale = 1.0f;
+			return false;
+		}
+		this->width_ = width;
+		this->height_ = height;
+		return true;
+	}
+
+	void release() {
+		if (this->fbo_)
+			glDeleteFramebuffers(1, &this->fbo_);
+		if (this->color_)
+			glDeleteRenderbuffers(1, &this->color_);
+		if (this->depth_)
+			glDeleteRenderbuffers(1, &this->depth_);
+		this->fbo_ = this->color_ = this->depth_ = 0;
+		this->width_ = this->height_ = 0;
+	}
+
+	DisplayConfig config_;
+	int virtualWidth_, virtualHeight_;
+	int windowWidth_ = 0, windowHeight_ = 0;
+	Viewport viewport_{ 0, 0, 0, 0 };
+
+	GLuint fbo_ = 0, color_ = 0, depth_ = 0;
+	int width_ = 0, height_ = 0;
+	bool offscreen_ = false;
+
+	GpuTimer timer_;
+	bool timed_ = false;        // a timer query has answered, so CPU times are no longer used
+	RenderScaler scaler_;
+	std::chrono::steady_clock::time_point started_;
+
+	FramePacer pacer_;
+};
+
+#endif // !SCREEN_H
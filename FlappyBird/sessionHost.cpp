@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "sessionHost.h"
+#include "netProtocol.h"
+
+
+namespace {
+	constexpr std::uint64_t LISTENER_KEY = ~0ull;
+	// Sessions run at the default GameConfig::tickRate
+	const std::chrono::duration<double> TICK_PERIOD(1.0 / GameRules::TICK_RATE);
+}
+
+
+SessionHost::SessionHost(JobSystem &jobs, const HostConfig &config)
+	: jobs_(jobs), config_(config)
+{
+	net::startUp();
+	this->listener_ = net::listenLocal(config.port);
+	this->port_ = net::localPort(this->listener_);
+	this->poller_.add(this->listener_, LISTENER_KEY);
+}
+
+
+SessionHost::~SessionHost() {
+	for (std::size_t i = 0; i < this->sessions_.size(); ++i)
+		if (this->sessions_[i])
+			this->drop(i);
+	net::close(this->listener_);
+}
+
+
+void SessionHost::run(const std::atomic<bool> &stop) {
+	using clock = std::chrono::steady_clock;
+	auto next = clock::now();
+	while (!stop) {
+		// Always poll, even when late, so inputs keep flowing under load
+		auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - clock::now()).count();
+		this->poll(static_cast<int>(std::max<long long>(wait, 0)));
+
+		if (clock::now() >= next) {
+			this->tick();
+			next += std::chrono::duration_cast<clock::duration>(TICK_PERIOD);
+			// Fell more than a few ticks behind: skip them instead of bursting
+			if (clock::now() - next > 4 * TICK_PERIOD)
+				next = clock::now();
+		}
+	}
+}
+
+
+void SessionHost::poll(int timeoutMs) {
+	this->poller_.wait(timeoutMs, this->events_);
+	for (const auto &e : this->events_) {
+		if (e.key == LISTENER_KEY) {
+			this->acceptAll();
+			continue;
+		}
+		std::size_t slot = static_cast<std::size_t>(e.key);
+		if (slot >= this->sessions_.size() || !this->sessions_[slot])
+			continue;
+		if (e.error) {
+			this->drop(slot);
+			continue;
+		}
+		if (e.readable)
+			this->read(slot);
+		if (e.writable && this->sessions_[slot])
+			this->flush(slot);
+	}
+}
+
+
+void SessionHost::tick() {
+	auto start = std::chrono::steady_clock::now();
+
+	// Batch: one job per chunk of slots, every job touches only its own sessions
+	std::size_t count = this->sessions_.size();
+	std::size_t chunk = this->config_.chunk;
+	for (std::size_t first = 0; first < count; first += chunk) {
+		std::size_t last = std::min(first + chunk, count);
+		this->jobs_.add([this, first, last] {
+			for (std::size_t i = first; i < last; ++i)
+				if (this->sessions_[i] && this->sessions_[i]->joined)
+					this->step(*this->sessions_[i]);
+		});
+	}
+	this->jobs_.wait();
+
+	for (std::size_t i = 0; i < count; ++i) {
+		Session *s = this->sessions_[i].get();
+		if (!s || !s->joined)
+			continue;
+		if (!s->finished) {
+			++this->stats_.steps;
+			s->finished = s->game.over();
+		}
+		if (s->out.size() > s->sent)
+			this->flush(i);
+	}
+
+	++this->stats_.ticks;
+	this->stats_.tickSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+void SessionHost::step(Session &s) {
+	// A lost game sends its last snapshot once and then waits for a new Join
+	if (s.finished)
+		return;
+
+	if (!s.game.over()) {
+		// Inputs for this or an earlier tick apply now; late inputs are not lost
+		std::uint32_t next = s.game.tick() + 1;
+		bool flap = false;
+		auto keep = std::remove_if(s.flaps.begin(), s.flaps.end(),
+			[next, &flap](std::uint32_t t) { return t <= next ? (flap = true) : false; });
+		s.flaps.erase(keep, s.flaps.end());
+		s.game.step(flap);
+	}
+
+	net::Snapshot snapshot = net::takeSnapshot(s.game, this->config_.quantization);
+	net::writeSnapshot(s.out, snapshot, s.acked ? s.history.find(s.acked) : nullptr);
+	s.history.put(snapshot);
+}
+
+
+void SessionHost::acceptAll() {
+	for (;;) {
+		net::Socket socket = net::accept(this->listener_);
+		if (socket == net::INVALID)
+			return;
+
+		std::size_t slot;
+		if (!this->free_.empty()) {
+			slot = this->free_.back();
+			this->free_.pop_back();
+		}
+		else {
+			slot = this->sessions_.size();
+			this->sessions_.emplace_back();
+		}
+
+		GameConfig config;
+		config.tubeNum = this->config_.tubeNum;
+		std::unique_ptr<Session> s(new Session(socket, GameSim(config)));
+		this->sessions_[slot] = std::move(s);
+		this->poller_.add(socket, slot);
+		++this->stats_.sessions;
+	}
+}
+
+
+void SessionHost::read(std::size_t slot) {
+	Session &s = *this->sessions_[slot];
+	std::uint8_t buffer[4096];
+	for (;;) {
+		long n = net::recv(s.socket, buffer, sizeof(buffer));
+		if (n < 0) {
+			this->drop(slot);
+			return;
+		}
+		if (n == 0)
+			break;
+		s.in.insert(s.in.end(), buffer, buffer + n);
+		this->stats_.bytesIn += n;
+	}
+
+	std::size_t pos = 0;
+	while (s.in.size() - pos >= net::CLIENT_MESSAGE_SIZE) {
+		const std::uint8_t *msg = s.in.data() + pos;
+		if (msg[0] == net::MSG_JOIN) {
+			net::Join join = net::readJoin(msg);
+			GameConfig config;
+			config.seed = join.seed;
+			config.mode = join.mode;
+			config.tubeNum = this->config_.tubeNum;
+			s.game.reset(config);
+			s.flaps.clear();
+			s.history.clear();
+			s.acked = 0;
+			s.joined = true;
+			s.finished = false;
+		}
+		else if (msg[0] == net::MSG_INPUT) {
+			net::Input input = net::readInput(msg);
+			if (input.flap && s.joined) {
+				// Inputs far in the future would pile up unapplied; an honest
+				// client is never more than its round trip ahead
+				if (input.tick > s.game.tick() + this->config_.inputAhead || s.flaps.size() >= this->config_.maxFlaps) {
+					std::cerr << "ERROR: in " << __FILE__
+						<< " line " << __LINE__
+						<< ": input flood from session " << slot << std::endl;
+					this->drop(slot);
+					return;
+				}
+				s.flaps.push_back(input.tick);
+			}
+		}
+		else if (msg[0] == net::MSG_ACK) {
+			std::uint32_t tick = net::readAck(msg);
+			if (tick > s.acked && tick <= s.game.tick())
+				s.acked = tick;
+		}
+		else {
+			std::cerr << "ERROR: in " << __FILE__
+				<< " line " << __LINE__
+				<< ": bad message from session " << slot << std::endl;
+			this->drop(slot);
+			return;
+		}
+		pos += net::CLIENT_MESSAGE_SIZE;
+	}
+	s.in.erase(s.in.begin(), s.in.begin() + pos);
+}
+
+
+void SessionHost::flush(std::size_t slot) {
+	Session &s = *this->sessions_[slot];
+	while (s.sent < s.out.size()) {
+		long n = net::send(s.socket, s.out.data() + s.sent, s.out.size() - s.sent);
+		if (n < 0) {
+			this->drop(slot);
+			return;
+		}
+		if (n == 0)
+			break;
+		s.sent += n;
+		this->stats_.bytesOut += n;
+	}
+
+	bool pending = s.sent < s.out.size();
+	if (!pending) {
+		s.out.clear();
+		s.sent = 0;
+	}
+	else if (s.out.size() - s.sent > this->config_.maxOutput) {
+		// Client does not keep up
+		this->drop(slot);
+		return;
+	}
+
+	if (pending != s.writing) {
+		this->poller_.modify(s.socket, slot, pending);
+		s.writing = pending;
+	}
+}
+
+
+void SessionHost::drop(std::size_t slot) {
+	Session &s = *this->sessions_[slot];
+	this->poller_.remove(s.socket);
+	net::close(s.socket);
+	this->sessions_[slot].reset();
+	this->free_.push_back(slot);
+	--this->stats_.sessions;
+	++this->stats_.dropped;
+}
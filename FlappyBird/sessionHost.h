@@ -0,0 +1,103 @@
+#ifndef SESSIONHOST_H
+#define SESSIONHOST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "gameSim.h"
+#include "jobSystem.h"
+#include "netSocket.h"
+#include "snapshotCodec.h"
+
+
+// Settings of the session host
+struct HostConfig {
+	std::uint16_t port = 7777;        // 0 picks a free port
+	std::size_t tubeNum = 999;        // per session course length
+	std::size_t chunk = 256;          // sessions per tick job
+	std::size_t maxOutput = 64 * 1024; // drop a client whose unsent bytes exceed this
+	std::uint32_t inputAhead = 60;    // drop a client sending input more ticks ahead than this
+	std::size_t maxFlaps = 64;        // or with more flap inputs pending than this
+	net::Quantization quantization;   // fixed point of snapshot positions
+};
+
+
+// Counters since the host started
+struct HostStats {
+	std::size_t sessions = 0;
+	std::uint64_t ticks = 0;
+	std::uint64_t steps = 0;          // session ticks simulated
+	std::uint64_t bytesIn = 0;
+	std::uint64_t bytesOut = 0;
+	std::uint64_t dropped = 0;
+	double tickSeconds = 0.0;         // time spent in tick()
+};
+
+
+/*
+\  Authoritative game server: every client connection owns one GameSim.
+\  I/O runs on the calling thread with a non-blocking Poller; once per TICK all
+\  sessions are advanced together as chunk jobs on the JobSystem, each job
+\  stepping its sessions and encoding their snapshots into their own buffers.
+*/
+class SessionHost {
+public:
+	SessionHost(JobSystem &jobs, const HostConfig &config = HostConfig());
+	~SessionHost();
+
+	SessionHost(const SessionHost &) = delete;
+	SessionHost(SessionHost &&) = delete;
+	SessionHost& operator=(const SessionHost &) = delete;
+	SessionHost& operator=(SessionHost &&) = delete;
+
+	std::uint16_t port() const noexcept { return this->port_; }
+
+	// Serve at GameRules::TICK_RATE ticks per second until stop becomes true
+	void run(const std::atomic<bool> &stop);
+
+	// Accept, read and write for up to timeoutMs
+	void poll(int timeoutMs);
+
+	// Advance every joined session by one tick and queue its snapshot
+	void tick();
+
+	const HostStats &stats() const noexcept { return this->stats_; }
+
+private:
+	struct Session {
+		Session(net::Socket socket, const GameSim &game) : socket(socket), game(game) {}
+
+		net::Socket socket = net::INVALID;
+		GameSim game;
+		bool joined = false;
+		bool finished = false;        // final snapshot of a lost game already queued
+		bool writing = false;         // registered for writability
+		std::vector<std::uint32_t> flaps;   // ticks of pending flap inputs, arrival order
+		net::SnapshotHistory history;       // snapshots sent, baselines for delta encoding
+		std::uint32_t acked = 0;            // newest tick the client acknowledged, 0 for none
+		std::vector<std::uint8_t> in;
+		std::vector<std::uint8_t> out;
+		std::size_t sent = 0;         // bytes of out already on the wire
+	};
+
+	void acceptAll();
+	void read(std::size_t slot);
+	void flush(std::size_t slot);
+	void drop(std::size_t slot);
+	void step(Session &s);
+
+	JobSystem &jobs_;
+	HostConfig config_;
+	net::Poller poller_;
+	net::Socket listener_;
+	std::uint16_t port_;
+
+	std::vector<std::unique_ptr<Session>> sessions_;   // null slots are free
+	std::vector<std::size_t> free_;
+	std::vector<net::Poller::Event> events_;
+	HostStats stats_;
+};
+
+#endif // !SESSIONHOST_H
@@ -2,8 +2,10 @@
 #define SHADER_H
 
 #include <iostream>
+#include <memory>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <sstream>
 #include "gl\glew.h"
 #include "gl\freeglut.h"
@@ -28,11 +30,50 @@ public:
 			vertexCode = vertexFile.read();
 			fragmentCode = fragmentFile.read();
 		}
+		this->build(vertexCode, fragmentCode);
+	}
+
+
+	// Compile from source text already in memory (see AssetPack)
+	static std::unique_ptr<Shader> fromSource(const string &vertexCode, const string &fragmentCode) {
+		std::unique_ptr<Shader> shader(new Shader());
+		shader->build(vertexCode, fragmentCode);
+		return shader;
+	}
+
+
+	// Load a program saved with binary(); null when the driver rejects it
+	static std::unique_ptr<Shader> fromBinary(GLenum format, const void *data, GLsizei size) {
+		std::unique_ptr<Shader> shader(new Shader());
+		shader->program_ = glCreateProgram();
+		glProgramBinary(shader->program_, format, data, size);
+		GLint success;
+		glGetProgramiv(shader->program_, GL_LINK_STATUS, &success);
+		if (!success) {
+			glDeleteProgram(shader->program_);
+			return nullptr;
+		}
+		return shader;
+	}
+
+
+	Shader(const char *vertexPath, const char *geometryPath, const char *fragmentPath) {
+		string vertexCode, geometryCode, fragmentCode;
+		{
+			FileHelper vertexFile(vertexPath);
+			FileHelper geometryFile(geometryPath);
+			FileHelper fragmentFile(fragmentPath);
+			vertexCode = vertexFile.read();
+			geometryCode = geometryFile.read();
+			fragmentCode = fragmentFile.read();
+		}
 
 		const GLchar *vShaderCode = vertexCode.c_str();
+		const GLchar *gShaderCode = geometryCode.c_str();
 		const GLchar *fShaderCode = fragmentCode.c_str();
 
-		GLuint vertex, fragment;
+
+		GLuint vertex, geometry, fragment;
 		GLint success;
 		GLchar infoLog[512];
 
@@ -45,6 +86,15 @@ public:
 			std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
 		}
 
+		geometry = glCreateShader(GL_GEOMETRY_SHADER);
+		glShaderSource(geometry, 1, &gShaderCode, NULL);
+		glCompileShader(geometry);
+		glGetShaderiv(geometry, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			glGetShaderInfoLog(geometry, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::GEOMETRY::COMPILATION_FAILED\n" << infoLog << std::endl;
+		}
+
 		fragment = glCreateShader(GL_FRAGMENT_SHADER);
 		glShaderSource(fragment, 1, &fShaderCode, NULL);
 		glCompileShader(fragment);
@@ -56,6 +106,7 @@ public:
 
 		program_ = glCreateProgram();
 		glAttachShader(program_, vertex);
+		glAttachShader(program_, geometry);
 		glAttachShader(program_, fragment);
 		glLinkProgram(program_);
 		glGetProgramiv(program_, GL_LINK_STATUS, &success);
@@ -65,27 +116,108 @@ public:
 		}
 
 		glDeleteShader(vertex);
+		glDeleteShader(geometry);
 		glDeleteShader(fragment);
 	}
 
 
-	Shader(const char *vertexPath, const char *geometryPath, const char *fragmentPath) {
-		string vertexCode, geometryCode, fragmentCode;
-		{
-			FileHelper vertexFile(vertexPath);
-			FileHelper geometryFile(geometryPath);
-			FileHelper fragmentFile(fragmentPath);
-			vertexCode = vertexFile.read();
-			geometryCode = geometryFile.read();
-			fragmentCode = fragmentFile.read();
+	// A rebuild in flight, see begin() and swap()
+	struct Pending {
+		GLuint vertex = 0;
+		GLuint fragment = 0;
+		GLuint program = 0;
+
+		bool started() const noexcept { return program != 0; }
+		// With GL_ARB_parallel_shader_compile the driver builds on its own threads
+		bool ready() const {
+			if (!GLEW_ARB_parallel_shader_compile)
+				return true;
+			GLint done = GL_TRUE;
+			glGetProgramiv(program, GL_COMPLETION_STATUS_ARB, &done);
+			return done == GL_TRUE;
 		}
+	};
 
+	// Start compiling and linking new sources without asking for the result
+	static Pending begin(const string &vertexCode, const string &fragmentCode) {
 		const GLchar *vShaderCode = vertexCode.c_str();
-		const GLchar *gShaderCode = geometryCode.c_str();
 		const GLchar *fShaderCode = fragmentCode.c_str();
+		Pending p;
+		p.vertex = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(p.vertex, 1, &vShaderCode, NULL);
+		glCompileShader(p.vertex);
+		p.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(p.fragment, 1, &fShaderCode, NULL);
+		glCompileShader(p.fragment);
+		p.program = glCreateProgram();
+		glAttachShader(p.program, p.vertex);
+		glAttachShader(p.program, p.fragment);
+		glLinkProgram(p.program);
+		return p;
+	}
 
+	// Finish a ready rebuild: the new program replaces this one when it linked,
+	// otherwise the errors are printed and the old program stays
+	bool swap(Pending &pending) {
+		GLint success;
+		GLchar infoLog[512];
+		glGetShaderiv(pending.vertex, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			glGetShaderInfoLog(pending.vertex, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+		}
+		glGetShaderiv(pending.fragment, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			glGetShaderInfoLog(pending.fragment, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+		}
+		glGetProgramiv(pending.program, GL_LINK_STATUS, &success);
+		if (!success) {
+			glGetProgramInfoLog(pending.program, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		}
 
-		GLuint vertex, geometry, fragment;
+		glDeleteShader(pending.vertex);
+		glDeleteShader(pending.fragment);
+		if (success) {
+			glDeleteProgram(program_);
+			program_ = pending.program;
+		}
+		else {
+			glDeleteProgram(pending.program);
+		}
+		pending = Pending();
+		return success == GL_TRUE;
+	}
+
+
+	void use() const noexcept { glUseProgram(program_); }
+
+	GLuint getProgram() const noexcept { return program_; }
+
+	// Driver specific binary of the linked program; false when it did not link
+	bool binary(GLenum &format, std::vector<char> &data) const {
+		GLint success, length = 0;
+		glGetProgramiv(program_, GL_LINK_STATUS, &success);
+		glGetProgramiv(program_, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (!success || length <= 0)
+			return false;
+		data.resize(length);
+		glGetProgramBinary(program_, length, &length, &format, data.data());
+		data.resize(length);
+		return length > 0;
+	}
+
+private:
+	GLuint program_;
+
+	Shader() = default;
+
+	void build(const string &vertexCode, const string &fragmentCode) {
+		const GLchar *vShaderCode = vertexCode.c_str();
+		const GLchar *fShaderCode = fragmentCode.c_str();
+
+		GLuint vertex, fragment;
 		GLint success;
 		GLchar infoLog[512];
 
@@ -98,15 +230,6 @@ public:
 			std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
 		}
 
-		geometry = glCreateShader(GL_GEOMETRY_SHADER);
-		glShaderSource(geometry, 1, &gShaderCode, NULL);
-		glCompileShader(geometry);
-		glGetShaderiv(geometry, GL_COMPILE_STATUS, &success);
-		if (!success) {
-			glGetShaderInfoLog(geometry, 512, NULL, infoLog);
-			std::cout << "ERROR::SHADER::GEOMETRY::COMPILATION_FAILED\n" << infoLog << std::endl;
-		}
-
 		fragment = glCreateShader(GL_FRAGMENT_SHADER);
 		glShaderSource(fragment, 1, &fShaderCode, NULL);
 		glCompileShader(fragment);
@@ -118,8 +241,9 @@ public:
 
 		program_ = glCreateProgram();
 		glAttachShader(program_, vertex);
-		glAttachShader(program_, geometry);
 		glAttachShader(program_, fragment);
+		// Lets ShaderCache save the linked binary
+		glProgramParameteri(program_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(program_);
 		glGetProgramiv(program_, GL_LINK_STATUS, &success);
 		if (!success) {
@@ -128,18 +252,10 @@ public:
 		}
 
 		glDeleteShader(vertex);
-		glDeleteShader(geometry);
 		glDeleteShader(fragment);
 	}
 
 
-	void use() const noexcept { glUseProgram(program_); }
-
-	GLuint getProgram() const noexcept { return program_; }
-
-private:
-	GLuint program_;
-
 	class FileHelper {
 	public:
 		FileHelper(const char *filePath) : path_(filePath), isLoaded_(false),
@@ -0,0 +1,235 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GL\glew.h"
+#include "shader.h"
+#include "fileWatcher.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+
+/*
+\  Process-wide shader programs, keyed by a hash of their sources: the same
+\  vertex + fragment pair is compiled once however many users ask for it.
+\  Linked programs are also saved with glGetProgramBinary under directory,
+\  keyed by the driver (vendor, renderer, version) and the sources, so later
+\  launches skip compiling. A missing, stale or rejected binary falls back
+\  to compiling from source and is rewritten.
+\
+\  With watchFiles(true), programs registered through watch() are rebuilt
+\  when their source files change: a FileWatcher thread notices the change,
+\  update() starts the rebuild at a frame boundary and swaps the program in
+\  place once the driver is done, so every Shader pointer stays valid. A
+\  source that fails to compile leaves the old program running.
+*/
+class ShaderCache {
+public:
+	// An empty directory keeps programs in memory only
+	explicit ShaderCache(std::string directory = "shadercache") : directory_(std::move(directory)) {}
+
+	ShaderCache(const ShaderCache &) = delete;
+	ShaderCache(ShaderCache &&) = delete;
+	ShaderCache &operator=(const ShaderCache &) = delete;
+	ShaderCache &operator=(ShaderCache &&) = delete;
+
+	// Program of the sources; stays valid as long as the cache
+	Shader &get(const std::string &vertexCode, const std::string &fragmentCode) {
+		std::uint64_t key = hash(vertexCode, hash(fragmentCode));
+		auto it = this->programs_.find(key);
+		if (it != this->programs_.end()) {
+			++this->shared_;
+			return *it->second;
+		}
+
+		std::unique_ptr<Shader> shader = this->load(key);
+		if (shader) {
+			++this->loaded_;
+		}
+		else {
+			shader = Shader::fromSource(vertexCode, fragmentCode);
+			++this->compiled_;
+			this->save(key, *shader);
+		}
+		return *this->programs_.emplace(key, std::move(shader)).first->second;
+	}
+
+	// Turn file watching on or off; watch() calls made while off are ignored
+	void watchFiles(bool on) {
+		if (!on)
+			this->watched_.clear();
+		this->watcher_ = on ? std::make_unique<FileWatcher>() : nullptr;
+	}
+
+	// Rebuild shader from these files whenever one of them changes
+	void watch(const std::string &vertexPath, const std::string &fragmentPath, Shader &shader) {
+		if (!this->watcher_)
+			return;
+		for (const Watched &w : this->watched_)
+			if (w.shader == &shader)
+				return;     // shared by several users
+		this->watcher_->add(vertexPath);
+		this->watcher_->add(fragmentPath);
+		this->watched_.push_back({ vertexPath, fragmentPath, &shader, false, Shader::Pending() });
+	}
+
+	// Once per frame, before drawing. Finishes rebuilds the driver is done with
+	// and starts at most one new one, so a burst of saves is spread over frames.
+	// Returns the number of programs replaced.
+	std::size_t update() {
+		if (!this->watcher_)
+			return 0;
+
+		for (const std::string &path : this->watcher_->changed())
+			for (Watched &w : this->watched_)
+				if (w.vertexPath == path || w.fragmentPath == path)
+					w.dirty = true;
+
+		std::size_t swapped = 0;
+		bool started = false;
+		for (Watched &w : this->watched_) {
+			if (w.pending.started()) {
+				if (!w.pending.ready())
+					continue;
+				if (w.shader->swap(w.pending)) {
+					std::cout << "reloaded " << w.vertexPath << " + " << w.fragmentPath << std::endl;
+					++swapped;
+				}
+			}
+			// A save during a rebuild waits for it, then starts another
+			if (w.dirty && !w.pending.started() && !started) {
+				std::string vertexCode, fragmentCode;
+				if (!readText(w.vertexPath, vertexCode) || !readText(w.fragmentPath, fragmentCode))
+					continue;     // half written, try next frame
+				w.pending = Shader::begin(vertexCode, fragmentCode);
+				w.dirty = false;
+				started = true;
+			}
+		}
+		return swapped;
+	}
+
+	std::size_t size() const noexcept { return this->programs_.size(); }
+	// Programs compiled from source, read from disk, and requests served by an existing program
+	std::size_t compiled() const noexcept { return this->compiled_; }
+	std::size_t loaded() const noexcept { return this->loaded_; }
+	std::size_t shared() const noexcept { return this->shared_; }
+
+	// FNV-1a, chained through seed
+	static std::uint64_t hash(const std::string &text, std::uint64_t seed = 14695981039346656037ull) noexcept {
+		for (char c : text)
+			seed = (seed ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		return seed;
+	}
+
+private:
+	static constexpr std::uint32_t MAGIC = 0x43534246;     // "FBSC"
+
+	struct Watched {
+		std::string vertexPath;
+		std::string fragmentPath;
+		Shader *shader;
+		bool dirty = false;
+		Shader::Pending pending;
+	};
+
+	static bool readText(const std::string &path, std::string &text) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			return false;
+		text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		return !text.empty();
+	}
+
+	// Binaries are only valid for the driver that made them
+	std::uint64_t driver() {
+		if (this->driver_ == 0) {
+			GLint formats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+			if (formats <= 0) {
+				this->directory_.clear();
+				return this->driver_ = 1;
+			}
+			std::string id;
+			for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+				const GLubyte *s = glGetString(name);
+				id += s ? reinterpret_cast<const char*>(s) : "";
+				id += '\n';
+			}
+			this->driver_ = hash(id);
+		}
+		return this->driver_;
+	}
+
+	std::string file(std::uint64_t key) {
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key ^ this->driver()));
+		return this->directory_ + "/" + name;
+	}
+
+	std::unique_ptr<Shader> load(std::uint64_t key) {
+		if (this->directory_.empty() || this->driver() == 1)
+			return nullptr;
+
+		std::ifstream in(this->file(key), std::ios::binary);
+		std::uint32_t magic = 0, format = 0, length = 0;
+		std::uint64_t driver = 0, source = 0;
+		in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+		in.read(reinterpret_cast<char*>(&driver), sizeof(driver));
+		in.read(reinterpret_cast<char*>(&source), sizeof(source));
+		in.read(reinterpret_cast<char*>(&format), sizeof(format));
+		in.read(reinterpret_cast<char*>(&length), sizeof(length));
+		if (!in || magic != MAGIC || driver != this->driver() || source != key || length == 0)
+			return nullptr;
+
+		std::vector<char> data(length);
+		if (!in.read(data.data(), length))
+			return nullptr;
+		return Shader::fromBinary(format, data.data(), static_cast<GLsizei>(length));
+	}
+
+	void save(std::uint64_t key, const Shader &shader) {
+		GLenum format;
+		std::vector<char> data;
+		if (this->directory_.empty() || this->driver() == 1 || !shader.binary(format, data))
+			return;
+
+#ifdef _WIN32
+		_mkdir(this->directory_.c_str());
+#else
+		mkdir(this->directory_.c_str(), 0755);
+#endif
+		std::ofstream out(this->file(key), std::ios::binary | std::ios::trunc);
+		std::uint32_t magic = MAGIC, fmt = format, length = static_cast<std::uint32_t>(data.size());
+		std::uint64_t driver = this->driver();
+		out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+		out.write(reinterpret_cast<const char*>(&driver), sizeof(driver));
+		out.write(reinterpret_cast<const char*>(&key), sizeof(key));
+		out.write(reinterpret_cast<const char*>(&fmt), sizeof(fmt));
+		out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		out.write(data.data(), length);
+	}
+
+	std::string directory_;
+	std::uint64_t driver_ = 0;       // 0 until asked, 1 when the driver has no binary formats
+	std::unordered_map<std::uint64_t, std::unique_ptr<Shader>> programs_;
+	std::size_t compiled_ = 0;
+	std::size_t loaded_ = 0;
+	std::size_t shared_ = 0;
+	std::unique_ptr<FileWatcher> watcher_;
+	std::vector<Watched> watched_;
+};
+
+#endif // !SHADERCACHE_H
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include "snapshotBench.h"
+#include "gameSim.h"
+#include "birdFlock.h"
+
+
+namespace {
+	constexpr std::uint32_t MAX_TICKS = 20000;
+
+	using Stream = std::vector<net::Snapshot>;
+
+	// One snapshot per tick of every game, flown by the GameSim autopilot
+	std::vector<Stream> record(std::size_t games, unsigned seed, const net::Quantization &q) {
+		std::vector<Stream> streams(games);
+		GameConfig config;
+		GameSim game(config);
+		for (std::size_t g = 0; g < games; ++g) {
+			config.seed = seed + static_cast<unsigned>(g);
+			game.reset(config);
+			std::default_random_engine e(config.seed);
+			float bias = std::uniform_real_distribution<float>(-60.0f, 20.0f)(e);
+			bool running = true;
+			while (running && game.tick() < MAX_TICKS) {
+				running = game.step(game.autoFlap(bias));
+				streams[g].push_back(net::takeSnapshot(game, q));
+			}
+		}
+		return streams;
+	}
+
+	// Encoded stream: bytes plus the end offset of every snapshot
+	struct Encoded {
+		std::vector<std::uint8_t> bytes;
+		std::vector<std::size_t> ends;
+	};
+}
+
+
+bool SnapshotBench::report(std::ostream &os, std::size_t fuzzRounds) const {
+	using clock = std::chrono::steady_clock;
+	bool ok = true;
+
+	os << "snapshot codec: " << this->games_ << " games, ack lag " << this->ackLag_ << " ticks\n";
+	os << std::setw(6) << "bits" << std::setw(10) << "ticks" << std::setw(10) << "B/tick"
+		<< std::setw(8) << "max B" << std::setw(11) << "keyframes" << std::setw(12) << "enc M/s"
+		<< std::setw(12) << "dec M/s" << std::setw(8) << "exact" << "\n";
+
+	Encoded sample;
+	Stream sampleStream;
+	for (int bits : { 0, 2, 4 }) {
+		net::Quantization q;
+		q.positionBits = bits;
+		std::vector<Stream> streams = record(this->games_, this->seed_, q);
+
+		// Encode every stream against the snapshot ackLag ticks back
+		std::vector<Encoded> encoded(streams.size());
+		std::size_t ticks = 0, keyframes = 0, maxSize = 0;
+		auto start = clock::now();
+		for (std::size_t g = 0; g < streams.size(); ++g) {
+			net::SnapshotHistory sent;
+			Encoded &out = encoded[g];
+			out.bytes.reserve(streams[g].size() * 8);
+			for (const auto &s : streams[g]) {
+				const net::Snapshot *baseline = s.tick > this->ackLag_ ? sent.find(s.tick - static_cast<std::uint32_t>(this->ackLag_)) : nullptr;
+				std::size_t size = net::SnapshotCodec::encode(s, baseline, out.bytes);
+				out.ends.push_back(out.bytes.size());
+				sent.put(s);
+				keyframes += baseline ? 0 : 1;
+				maxSize = std::max(maxSize, size);
+			}
+			ticks += streams[g].size();
+		}
+		double encodeSeconds = std::chrono::duration<double>(clock::now() - start).count();
+
+		// Decode and compare
+		bool exact = true;
+		std::size_t bytes = 0;
+		start = clock::now();
+		for (std::size_t g = 0; g < streams.size(); ++g) {
+			net::SnapshotHistory received;
+			const Encoded &in = encoded[g];
+			std::size_t begin = 0;
+			for (std::size_t i = 0; i < in.ends.size(); ++i) {
+				net::Snapshot s;
+				if (!net::SnapshotCodec::decode(in.bytes.data() + begin, in.ends[i] - begin, received, s) || s != streams[g][i])
+					exact = false;
+				received.put(s);
+				begin = in.ends[i];
+			}
+			bytes += in.bytes.size();
+		}
+		double decodeSeconds = std::chrono::duration<double>(clock::now() - start).count();
+		ok = ok && exact;
+
+		// Sizes include the 2 byte message header of the host protocol
+		os << std::setw(6) << bits << std::setw(10) << ticks
+			<< std::setw(10) << std::fixed << std::setprecision(2) << (bytes + 2.0 * ticks) / std::max<std::size_t>(ticks, 1)
+			<< std::setw(8) << maxSize + 2 << std::setw(11) << keyframes
+			<< std::setw(12) << ticks / encodeSeconds / 1e6
+			<< std::setw(12) << ticks / decodeSeconds / 1e6
+			<< std::setw(8) << (exact ? "yes" : "NO") << "\n";
+
+		if (!streams.empty() && !encoded.empty()) {
+			sample = std::move(encoded.front());
+			sampleStream = std::move(streams.front());
+		}
+	}
+
+	// Fuzz: mutated and random input must be rejected or decode to a sane snapshot
+	if (sample.ends.size() > 1 && fuzzRounds > 0) {
+		std::default_random_engine e(this->seed_);
+		net::SnapshotHistory history;
+		std::size_t middle = std::min<std::size_t>(sample.ends.size() - 1, 64);
+		for (std::size_t i = 0; i < middle; ++i)
+			history.put(sampleStream[i]);
+
+		std::size_t accepted = 0, insane = 0;
+		std::vector<std::uint8_t> data;
+		for (std::size_t round = 0; round < fuzzRounds; ++round) {
+			std::size_t pick = e() % sample.ends.size();
+			std::size_t begin = pick ? sample.ends[pick - 1] : 0;
+			data.assign(sample.bytes.begin() + begin, sample.bytes.begin() + sample.ends[pick]);
+
+			switch (e() % 4) {
+			case 0:    // flip bits
+				for (std::size_t n = 1 + e() % 4; n > 0 && !data.empty(); --n)
+					data[e() % data.size()] ^= static_cast<std::uint8_t>(1u << (e() % 8));
+				break;
+			case 1:    // truncate
+				data.resize(e() % (data.size() + 1));
+				break;
+			case 2:    // append garbage
+				for (std::size_t n = 1 + e() % 8; n > 0; --n)
+					data.push_back(static_cast<std::uint8_t>(e()));
+				break;
+			default:   // random bytes
+				data.resize(e() % (net::SnapshotCodec::MAX_SIZE + 1));
+				for (auto &b : data)
+					b = static_cast<std::uint8_t>(e());
+				break;
+			}
+
+			net::Snapshot s;
+			if (net::SnapshotCodec::decode(data.data(), data.size(), history, s)) {
+				++accepted;
+				if (s.tubeCount > net::MAX_VISIBLE_TUBES || s.frame >= BirdFlock::FrameCount)
+					++insane;
+			}
+		}
+		ok = ok && insane == 0;
+		os << "fuzz: " << fuzzRounds << " inputs, " << accepted << " accepted, "
+			<< fuzzRounds - accepted << " rejected, " << insane << " out of range\n";
+	}
+	return ok;
+}
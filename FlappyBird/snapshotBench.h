@@ -0,0 +1,29 @@
+#ifndef SNAPSHOTBENCH_H
+#define SNAPSHOTBENCH_H
+
+#include <cstddef>
+#include <iostream>
+#include "snapshotCodec.h"
+
+
+/*
+\  Offline check of SnapshotCodec on recorded autopilot games: bytes per tick,
+\  encode / decode throughput, round-trip exactness for several quantizations,
+\  and a fuzz pass feeding mutated and random bytes to the decoder.
+*/
+class SnapshotBench {
+public:
+	// ackLag: how many ticks the baseline trails the snapshot, like a client's round trip
+	SnapshotBench(std::size_t games, std::size_t ackLag = 3, unsigned seed = 0)
+		: games_(games), ackLag_(ackLag ? ackLag : 1), seed_(seed) {}
+
+	// Returns false when a round trip was not exact or the fuzz pass found a problem
+	bool report(std::ostream &os, std::size_t fuzzRounds = 1000000) const;
+
+private:
+	std::size_t games_;
+	std::size_t ackLag_;
+	unsigned seed_;
+};
+
+#endif // !SNAPSHOTBENCH_H
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <cmath>
+#include "snapshotCodec.h"
+#include "birdFlock.h"
+
+
+namespace net {
+
+	constexpr std::size_t SnapshotHistory::HISTORY;
+	constexpr std::size_t SnapshotCodec::MAX_SIZE;
+
+	namespace {
+		std::int32_t toFixed(float v, int bits) {
+			double q = std::round(std::ldexp(static_cast<double>(v), bits));
+			return static_cast<std::int32_t>(std::max(-2147483648.0, std::min(2147483647.0, q)));
+		}
+
+		std::uint32_t zigzag(std::int32_t v) {
+			return (static_cast<std::uint32_t>(v) << 1) ^ static_cast<std::uint32_t>(v >> 31);
+		}
+
+		std::int32_t unzigzag(std::uint32_t v) {
+			return static_cast<std::int32_t>(v >> 1) ^ -static_cast<std::int32_t>(v & 1);
+		}
+
+		// Wrapping difference, so any int32 pair round-trips
+		std::int32_t diff(std::int32_t a, std::int32_t b) {
+			return static_cast<std::int32_t>(static_cast<std::uint32_t>(a) - static_cast<std::uint32_t>(b));
+		}
+
+		std::int32_t sum(std::int32_t a, std::int32_t b) {
+			return static_cast<std::int32_t>(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(b));
+		}
+
+
+		// LSB first bit stream, whole bytes are flushed from a 64 bit accumulator
+		class BitWriter {
+		public:
+			explicit BitWriter(std::vector<std::uint8_t> &out) : out_(out), start_(out.size()) {}
+			~BitWriter() { this->flush(); }
+
+			void bits(std::uint32_t v, int n) {
+				if (n < 32)
+					v &= (1u << n) - 1;
+				this->acc_ |= static_cast<std::uint64_t>(v) << this->count_;
+				this->count_ += n;
+				while (this->count_ >= 8) {
+					this->out_.push_back(static_cast<std::uint8_t>(this->acc_));
+					this->acc_ >>= 8;
+					this->count_ -= 8;
+				}
+			}
+
+			// 0 -> "0", otherwise "1", 5 bit length - 1, then the value
+			void uvar(std::uint32_t v) {
+				if (v == 0) {
+					this->bits(0, 1);
+					return;
+				}
+				int n = 0;
+				while (n < 32 && (v >> n) != 0)
+					++n;
+				this->bits(1 | static_cast<std::uint32_t>(n - 1) << 1, 6);
+				this->bits(v, n);
+			}
+
+			void svar(std::int32_t v) { this->uvar(zigzag(v)); }
+
+			// Pads the last byte with zero bits
+			void flush() {
+				if (this->count_ > 0) {
+					this->out_.push_back(static_cast<std::uint8_t>(this->acc_));
+					this->acc_ = 0;
+					this->count_ = 0;
+				}
+			}
+
+			std::size_t size() const { return this->out_.size() - this->start_ + (this->count_ > 0 ? 1 : 0); }
+
+		private:
+			std::vector<std::uint8_t> &out_;
+			std::size_t start_;
+			std::uint64_t acc_ = 0;
+			int count_ = 0;
+		};
+
+
+		class BitReader {
+		public:
+			BitReader(const std::uint8_t *data, std::size_t size) : data_(data), size_(size) {}
+
+			std::uint32_t bits(int n) {
+				while (this->count_ < n) {
+					if (this->pos_ >= this->size_) {
+						this->fail_ = true;
+						return 0;
+					}
+					this->acc_ |= static_cast<std::uint64_t>(this->data_[this->pos_++]) << this->count_;
+					this->count_ += 8;
+				}
+				std::uint32_t v = static_cast<std::uint32_t>(this->acc_ & ((std::uint64_t(1) << n) - 1));
+				this->acc_ >>= n;
+				this->count_ -= n;
+				return v;
+			}
+
+			std::uint32_t uvar() {
+				if (!this->bits(1))
+					return 0;
+				int n = static_cast<int>(this->bits(5)) + 1;
+				return this->bits(n);
+			}
+
+			std::int32_t svar() { return unzigzag(this->uvar()); }
+
+			bool failed() const { return this->fail_; }
+
+		private:
+			const std::uint8_t *data_;
+			std::size_t size_;
+			std::size_t pos_ = 0;
+			std::uint64_t acc_ = 0;
+			int count_ = 0;
+			bool fail_ = false;
+		};
+
+
+		bool inWindow(const Snapshot &s, std::uint32_t index) {
+			return index >= s.firstTube && index - s.firstTube < s.tubeCount;
+		}
+	}
+
+
+	std::int32_t Quantization::position(float v) const noexcept { return toFixed(v, this->positionBits); }
+	std::int32_t Quantization::velocity(float v) const noexcept { return toFixed(v, this->velocityBits); }
+	float Quantization::position(std::int32_t q) const noexcept { return std::ldexp(static_cast<float>(q), -this->positionBits); }
+	float Quantization::velocity(std::int32_t q) const noexcept { return std::ldexp(static_cast<float>(q), -this->velocityBits); }
+
+
+	bool Snapshot::operator==(const Snapshot &s) const noexcept {
+		if (this->tick != s.tick || this->birdY != s.birdY || this->birdV != s.birdV
+			|| this->frame != s.frame || this->score != s.score || this->over != s.over
+			|| this->scroll != s.scroll || this->firstTube != s.firstTube || this->tubeCount != s.tubeCount)
+			return false;
+		for (std::uint8_t i = 0; i < this->tubeCount; ++i)
+			if (this->tubeX[i] != s.tubeX[i] || this->tubeY[i] != s.tubeY[i])
+				return false;
+		return true;
+	}
+
+
+	Snapshot takeSnapshot(const GameSim &game, const Quantization &q) {
+		Snapshot s;
+		s.tick = game.tick();
+		s.birdY = q.position(game.birdY());
+		s.birdV = q.velocity(game.birdVelocity());
+		s.frame = game.birdFrame();
+		s.score = static_cast<std::uint16_t>(game.score());
+		s.over = game.over();
+		s.scroll = q.position(game.scroll());
+
+		// The passed tube can still be on screen, so start one before the current
+		std::size_t first = game.currTube() > 0 ? game.currTube() - 1 : 0;
+		for (std::size_t i = first; i < game.tubeEnd() && s.tubeCount < MAX_VISIBLE_TUBES; ++i) {
+			GameSim::TubeState tube = game.tube(i);
+			float x = tube.x + game.scroll();
+			if (x > VISIBLE_X)
+				break;
+			if (x < -VISIBLE_X)
+				continue;
+			if (s.tubeCount == 0)
+				s.firstTube = static_cast<std::uint32_t>(i);
+			s.tubeX[s.tubeCount] = q.position(tube.x);
+			s.tubeY[s.tubeCount] = q.position(tube.y);
+			++s.tubeCount;
+		}
+		return s;
+	}
+
+
+	void SnapshotHistory::put(const Snapshot &s) noexcept {
+		std::size_t slot = s.tick % HISTORY;
+		this->ring_[slot] = s;
+		this->valid_[slot] = true;
+	}
+
+
+	const Snapshot *SnapshotHistory::find(std::uint32_t tick) const noexcept {
+		std::size_t slot = tick % HISTORY;
+		if (!this->valid_[slot] || this->ring_[slot].tick != tick)
+			return nullptr;
+		return &this->ring_[slot];
+	}
+
+
+	const Snapshot *SnapshotHistory::slot(std::size_t index) const noexcept {
+		if (index >= HISTORY || !this->valid_[index])
+			return nullptr;
+		return &this->ring_[index];
+	}
+
+
+	void SnapshotHistory::clear() noexcept {
+		std::fill(std::begin(this->valid_), std::end(this->valid_), false);
+	}
+
+
+	std::size_t SnapshotCodec::encode(const Snapshot &s, const Snapshot *baseline, std::vector<std::uint8_t> &out) {
+		static const Snapshot empty;
+		if (baseline && (s.tick <= baseline->tick || s.tick - baseline->tick >= SnapshotHistory::HISTORY))
+			baseline = nullptr;
+		const Snapshot &b = baseline ? *baseline : empty;
+
+		BitWriter w(out);
+		// Header: keyframe bit, then the full tick or baseline slot + tick delta
+		w.bits(baseline ? 0 : 1, 1);
+		if (baseline) {
+			w.bits(b.tick % SnapshotHistory::HISTORY, 5);
+			w.uvar(s.tick - b.tick - 1);
+		}
+		else {
+			w.bits(s.tick, 32);
+		}
+
+		w.bits(s.over ? 1 : 0, 1);
+		if (s.frame != b.frame) {
+			w.bits(1, 1);
+			w.bits(s.frame, 4);
+		}
+		else {
+			w.bits(0, 1);
+		}
+		w.svar(static_cast<std::int32_t>(s.score) - b.score);
+		w.svar(diff(s.birdY, b.birdY));
+		w.svar(diff(s.birdV, b.birdV));
+		w.svar(diff(s.scroll, b.scroll));
+
+		// Tube window: only tubes the baseline did not have are sent whole,
+		// the others only by how far their gap moved (one bit for a still tube)
+		w.svar(static_cast<std::int32_t>(s.firstTube - b.firstTube));
+		w.bits(s.tubeCount, 3);
+		std::int32_t lastX = 0;
+		for (std::uint8_t i = 0; i < s.tubeCount; ++i) {
+			std::uint32_t index = s.firstTube + i;
+			if (!inWindow(b, index)) {
+				w.svar(diff(s.tubeX[i], lastX));
+				w.svar(s.tubeY[i]);
+			}
+			else {
+				w.svar(diff(s.tubeY[i], b.tubeY[index - b.firstTube]));
+			}
+			lastX = s.tubeX[i];
+		}
+		w.flush();
+		return w.size();
+	}
+
+
+	bool SnapshotCodec::decode(const std::uint8_t *data, std::size_t size, const SnapshotHistory &history, Snapshot &s) {
+		static const Snapshot empty;
+		BitReader r(data, size);
+
+		Snapshot result;
+		const Snapshot *baseline = nullptr;
+		if (r.bits(1)) {
+			result.tick = r.bits(32);
+		}
+		else {
+			std::size_t slot = r.bits(5);
+			std::uint32_t delta = r.uvar();
+			if (r.failed() || delta >= SnapshotHistory::HISTORY - 1)
+				return false;
+			baseline = history.slot(slot);
+			if (!baseline)
+				return false;
+			result.tick = baseline->tick + delta + 1;
+		}
+		const Snapshot &b = baseline ? *baseline : empty;
+
+		result.over = r.bits(1) != 0;
+		result.frame = r.bits(1) ? static_cast<std::uint8_t>(r.bits(4)) : b.frame;
+		if (result.frame >= BirdFlock::FrameCount)
+			return false;
+		std::int32_t score = static_cast<std::int32_t>(b.score) + r.svar();
+		if (score < 0 || score > 0xffff)
+			return false;
+		result.score = static_cast<std::uint16_t>(score);
+		result.birdY = sum(b.birdY, r.svar());
+		result.birdV = sum(b.birdV, r.svar());
+		result.scroll = sum(b.scroll, r.svar());
+
+		result.firstTube = b.firstTube + static_cast<std::uint32_t>(r.svar());
+		result.tubeCount = static_cast<std::uint8_t>(r.bits(3));
+		if (result.tubeCount > MAX_VISIBLE_TUBES)
+			return false;
+		std::int32_t lastX = 0;
+		for (std::uint8_t i = 0; i < result.tubeCount; ++i) {
+			std::uint32_t index = result.firstTube + i;
+			if (inWindow(b, index)) {
+				result.tubeX[i] = b.tubeX[index - b.firstTube];
+				result.tubeY[i] = sum(b.tubeY[index - b.firstTube], r.svar());
+			}
+			else {
+				result.tubeX[i] = sum(lastX, r.svar());
+				result.tubeY[i] = r.svar();
+			}
+			lastX = result.tubeX[i];
+		}
+
+		if (r.failed())
+			return false;
+		s = result;
+		return true;
+	}
+
+}
@@ -0,0 +1,100 @@
+#ifndef SNAPSHOTCODEC_H
+#define SNAPSHOTCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "gameSim.h"
+
+
+namespace net {
+
+	constexpr std::size_t MAX_VISIBLE_TUBES = 4;
+	// Tubes whose screen x is inside [-VISIBLE_X, VISIBLE_X] are sent
+	constexpr float VISIBLE_X = 500.0f + GameRules::TUBE_HALFWIDTH;
+
+
+	// Fixed point used on the wire: value * 2^bits, rounded
+	struct Quantization {
+		int positionBits = 2;     // bird y, scroll, tube x / y
+		int velocityBits = 0;     // bird velocity
+
+		std::int32_t position(float v) const noexcept;
+		std::int32_t velocity(float v) const noexcept;
+		float position(std::int32_t q) const noexcept;
+		float velocity(std::int32_t q) const noexcept;
+	};
+
+
+	// Game state as seen by a viewer, already quantized.
+	// Tube x is in course coordinates, so its screen x is tubeX + scroll.
+	struct Snapshot {
+		std::uint32_t tick = 0;
+		std::int32_t birdY = 0;
+		std::int32_t birdV = 0;
+		std::uint8_t frame = 0;
+		std::uint16_t score = 0;
+		bool over = false;
+		std::int32_t scroll = 0;
+		std::uint32_t firstTube = 0;      // course index of tubeX[0]
+		std::uint8_t tubeCount = 0;
+		std::int32_t tubeX[MAX_VISIBLE_TUBES] = {};
+		std::int32_t tubeY[MAX_VISIBLE_TUBES] = {};
+
+		bool operator==(const Snapshot &s) const noexcept;
+		bool operator!=(const Snapshot &s) const noexcept { return !(*this == s); }
+	};
+
+	Snapshot takeSnapshot(const GameSim &game, const Quantization &q = Quantization());
+
+
+	// Last HISTORY snapshots of one stream, indexed by tick; both ends keep one
+	class SnapshotHistory {
+	public:
+		static constexpr std::size_t HISTORY = 32;
+
+		void put(const Snapshot &s) noexcept;
+		// Null when the tick is no longer (or not yet) stored
+		const Snapshot *find(std::uint32_t tick) const noexcept;
+		// Newest snapshot stored in a slot (tick % HISTORY), null when empty
+		const Snapshot *slot(std::size_t index) const noexcept;
+		void clear() noexcept;
+
+	private:
+		Snapshot ring_[HISTORY];
+		bool valid_[HISTORY] = {};
+	};
+
+
+	/*
+	\  Bit-packed delta encoding of Snapshot against a baseline the receiver has
+	\  acknowledged. Fields are zigzag deltas with a 5 bit length prefix, so an
+	\  unchanged field costs one bit, and tubes already in the baseline window
+	\  only send how far their gap moved. The baseline is named by its history
+	\  slot, not its full tick. Without a baseline the result is a
+	\  self-contained keyframe.
+	\
+	\  decode() never reads past size and rejects malformed input, so it is
+	\  safe on bytes straight from the network.
+	*/
+	class SnapshotCodec {
+	public:
+		// Upper bound of one encoded snapshot
+		static constexpr std::size_t MAX_SIZE = 96;
+
+		// baseline must be null or at most HISTORY - 1 ticks older than s.
+		// Appends the encoded bytes to out and returns their number.
+		static std::size_t encode(const Snapshot &s, const Snapshot *baseline, std::vector<std::uint8_t> &out);
+
+		// Looks the baseline up in history; false for malformed data or a missing baseline
+		static bool decode(const std::uint8_t *data, std::size_t size, const SnapshotHistory &history, Snapshot &s);
+
+		// True when the data is a keyframe (the receiver may drop its history)
+		static bool keyframe(const std::uint8_t *data, std::size_t size) noexcept {
+			return size > 0 && (data[0] & 1) != 0;
+		}
+	};
+
+}
+
+#endif // !SNAPSHOTCODEC_H
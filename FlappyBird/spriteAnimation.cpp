@@ -0,0 +1,54 @@
+#include "spriteAnimation.h"
+
+
+UvRect SpriteSheet::uv(int cell, float inset) const noexcept {
+	float w = static_cast<float>(this->width());
+	float h = static_cast<float>(this->height());
+	float x = static_cast<float>(this->x(cell));
+	float y = static_cast<float>(this->y(cell));
+	return { (x + inset) / w, (y + inset) / h, (x + this->cellWidth_ - inset) / w, (y + this->cellHeight_ - inset) / h };
+}
+
+
+std::uint8_t SpriteAnimation::addClip(std::vector<SpriteFrame> frames) {
+	this->clips_.push_back({ this->frames_.size(), static_cast<std::uint8_t>(frames.size()) });
+	this->frames_.insert(this->frames_.end(), frames.begin(), frames.end());
+	return static_cast<std::uint8_t>(this->clips_.size() - 1);
+}
+
+
+void SpriteAnimation::addTransition(const SpriteTransition &transition) {
+	this->transitions_.push_back(transition);
+}
+
+
+void SpriteAnimation::play(SpritePlayer &player, std::uint8_t clip) const noexcept {
+	player.clip = clip;
+	player.frame = 0;
+	player.time = 0.0f;
+}
+
+
+void SpriteAnimation::update(SpritePlayer &player, float value, float deltaTime) const noexcept {
+	for (const SpriteTransition &t : this->transitions_) {
+		if (t.from == player.clip && value > t.min && value < t.max) {
+			this->play(player, t.to);
+			break;
+		}
+	}
+	this->advance(player, deltaTime);
+}
+
+
+void SpriteAnimation::advance(SpritePlayer &player, float deltaTime) const noexcept {
+	const Clip &clip = this->clips_[player.clip];
+	player.time += deltaTime;
+	// A long step may pass several frames
+	for (;;) {
+		float duration = this->frames_[clip.first + player.frame].duration;
+		if (player.time < duration || duration <= 0.0f)
+			break;
+		player.time -= duration;
+		player.frame = static_cast<std::uint8_t>((player.frame + 1) % clip.count);
+	}
+}
@@ -0,0 +1,106 @@
+#ifndef SPRITEANIMATION_H
+#define SPRITEANIMATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+// Texture coordinates of a sprite sheet cell; v0 is the top row of the image
+struct UvRect {
+	float u0, v0, u1, v1;
+};
+
+
+/*
+\  Cells of equal size in a grid, numbered row by row. Each cell has a
+\  gutter of empty pixels around it and its UV rect is inset by half a
+\  texel, so linear filtering never picks up a neighbour.
+*/
+class SpriteSheet {
+public:
+	SpriteSheet(int columns, int rows, int cellWidth, int cellHeight, int gutter = 1)
+		: columns_(columns), rows_(rows), cellWidth_(cellWidth), cellHeight_(cellHeight), gutter_(gutter) {}
+
+	int width() const noexcept { return this->columns_ * (this->cellWidth_ + 2 * this->gutter_); }
+	int height() const noexcept { return this->rows_ * (this->cellHeight_ + 2 * this->gutter_); }
+	int cells() const noexcept { return this->columns_ * this->rows_; }
+
+	// Pixel position of a cell's top left corner
+	int x(int cell) const noexcept { return cell % this->columns_ * (this->cellWidth_ + 2 * this->gutter_) + this->gutter_; }
+	int y(int cell) const noexcept { return cell / this->columns_ * (this->cellHeight_ + 2 * this->gutter_) + this->gutter_; }
+
+	// inset: texels left off each edge, half a texel for linear filtering;
+	// 0 maps whole texels, for nearest filtering
+	UvRect uv(int cell, float inset = 0.5f) const noexcept;
+
+private:
+	int columns_, rows_;
+	int cellWidth_, cellHeight_;
+	int gutter_;
+};
+
+
+// One picture of a clip: a sheet cell shown for duration (simulation time)
+struct SpriteFrame {
+	std::uint8_t cell;
+	float duration;
+};
+
+
+// Taken when a sprite plays from and its driving value (e.g. vertical speed)
+// is strictly between min and max
+struct SpriteTransition {
+	std::uint8_t from;
+	std::uint8_t to;
+	float min = -std::numeric_limits<float>::infinity();
+	float max = std::numeric_limits<float>::infinity();
+};
+
+
+// Playback state of one sprite; small and trivially copyable, so thousands
+// of them sit in one vector next to the other per-bird arrays
+struct SpritePlayer {
+	std::uint8_t clip = 0;
+	std::uint8_t frame = 0;
+	float time = 0.0f;      // into the current frame
+};
+
+
+/*
+\  Looping clips and the transitions between them, shared by every sprite
+\  of a kind; the sprites themselves are only SpritePlayers. Everything
+\  advances with simulation time, so the animation looks the same at any
+\  frame rate and replays exactly from the same inputs.
+*/
+class SpriteAnimation {
+public:
+	// Returns the clip's id, in order from 0
+	std::uint8_t addClip(std::vector<SpriteFrame> frames);
+	void addTransition(const SpriteTransition &transition);
+
+	// Start clip from its first frame, also when it is already playing
+	void play(SpritePlayer &player, std::uint8_t clip) const noexcept;
+	// Follow the first transition value allows, then move time forward
+	void update(SpritePlayer &player, float value, float deltaTime) const noexcept;
+	void advance(SpritePlayer &player, float deltaTime) const noexcept;
+
+	std::uint8_t cell(const SpritePlayer &player) const noexcept {
+		return this->frames_[this->clips_[player.clip].first + player.frame].cell;
+	}
+
+	std::size_t clips() const noexcept { return this->clips_.size(); }
+
+private:
+	struct Clip {
+		std::size_t first;      // into frames_
+		std::uint8_t count;
+	};
+
+	std::vector<SpriteFrame> frames_;
+	std::vector<Clip> clips_;
+	std::vector<SpriteTransition> transitions_;
+};
+
+#endif // !SPRITEANIMATION_H
@@ -0,0 +1,58 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+
+/*
+\  Bounded lock-free queue for exactly one producer thread and one consumer
+\  thread. Neither side ever blocks or allocates: push() fails when the
+\  queue is full and pop() when it is empty. Capacity is a power of two.
+*/
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	SpscQueue() = default;
+
+	SpscQueue(const SpscQueue &) = delete;
+	SpscQueue(SpscQueue &&) = delete;
+	SpscQueue& operator=(const SpscQueue &) = delete;
+	SpscQueue& operator=(SpscQueue &&) = delete;
+
+	// Producer side
+	bool push(const T &item) noexcept {
+		std::size_t tail = this->tail_.load(std::memory_order_relaxed);
+		if (tail - this->head_.load(std::memory_order_acquire) == Capacity)
+			return false;
+		this->items_[tail & (Capacity - 1)] = item;
+		this->tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side
+	bool pop(T &item) noexcept {
+		std::size_t head = this->head_.load(std::memory_order_relaxed);
+		if (head == this->tail_.load(std::memory_order_acquire))
+			return false;
+		item = this->items_[head & (Capacity - 1)];
+		this->head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Either side; only a snapshot while the other side runs
+	std::size_t size() const noexcept {
+		return this->tail_.load(std::memory_order_acquire) - this->head_.load(std::memory_order_acquire);
+	}
+
+private:
+	T items_[Capacity];
+	// Separate cache lines, so the two threads do not fight over one.
+	// Owners made with new keep the alignment: the project builds as C++17.
+	alignas(64) std::atomic<std::size_t> head_{ 0 };
+	alignas(64) std::atomic<std::size_t> tail_{ 0 };
+};
+
+#endif // !SPSCQUEUE_H
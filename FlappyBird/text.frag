@@ -0,0 +1,16 @@
+#version 430 core
+
+in vec2 TexCoord;
+
+out vec4 color;
+
+uniform sampler2D fontTex;
+uniform vec4 textColor;
+
+void main()
+{
+	vec4 texColor = texture(fontTex, TexCoord);
+	if(texColor.a < 0.1)
+        discard;
+	color = texColor * textColor;
+}
@@ -0,0 +1,16 @@
+#version 430 core
+
+layout (location = 0) in vec2 corner;  // unit quad, 0..1
+layout (location = 1) in vec4 rect;    // per glyph <x, y, width, height>, x and y the bottom left
+layout (location = 2) in vec4 uvRect;  // per glyph <u0, v0, u1, v1> in the font sheet, v0 at the top
+
+uniform mat4 projection;
+uniform float z;
+
+out vec2 TexCoord;
+
+void main()
+{
+	gl_Position = projection * vec4(rect.xy + corner * rect.zw, z, 1.0f);
+	TexCoord = vec2(mix(uvRect.x, uvRect.z, corner.x), mix(uvRect.y, uvRect.w, 1.0f - corner.y));
+}
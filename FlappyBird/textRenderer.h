@@ -0,0 +1,235 @@
+#ifndef TEXTRENDERER_H
+#define TEXTRENDERER_H
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "GL\glew.h"
+#include "glm\glm.hpp"
+#include "glm\gtc\type_ptr.hpp"
+#include "drawAble.h"
+#include "shader.h"
+#include "config.h"
+#include "textureCache.h"
+#include "frameRing.h"
+#include "bitmapFont.h"
+
+
+/*
+\  Draws text of a BitmapFont, however long, with one instanced draw call:
+\  text() lays out glyph quads on the CPU, and submit() writes all of them
+\  into the frame's part of a FrameRing and queues one command. Text is
+\  immediate: give it every frame, then submit once; the glyphs are gone
+\  after the submit.
+*/
+class TextRenderer : public DrawAble {
+public:
+	// Font of the textures in cells, one glyph each in order, all of one size;
+	// map the characters afterwards through font()
+	TextRenderer(TextureCache &textures, FrameRing &ring, const std::vector<const char*> &cells,
+		GLfloat glyphWidth, GLfloat glyphHeight, GLfloat advance)
+		: ring_(ring), font_(TextRenderer::row(textures, cells), glyphWidth, glyphHeight, advance)
+	{
+		const SpriteSheet &sheet = this->font_.sheet();
+		this->createTexture(sheet, nullptr, GL_LINEAR);
+
+		// Cells are copied on the GPU from the textures in the cache
+		GLint cellWidth = 0, cellHeight = 0;
+		if (!cells.empty())
+			TextRenderer::size(textures.get(cells[0]), cellWidth, cellHeight);
+		for (std::size_t i = 0; i < cells.size(); ++i) {
+			GLuint source = textures.get(cells[i]);
+			GLint width = 0, height = 0;
+			TextRenderer::size(source, width, height);
+			if (width != cellWidth || height != cellHeight) {
+				std::cerr << "ERROR: in " << __FILE__
+					<< " line " << __LINE__
+					<< ": " << cells[i] << " is not " << cellWidth << "x" << cellHeight << ", left out of the font" << std::endl;
+				continue;
+			}
+			int cell = static_cast<int>(i);
+			glCopyImageSubData(source, GL_TEXTURE_2D, 0, 0, 0, 0,
+				this->texture_, GL_TEXTURE_2D, 0, sheet.x(cell), sheet.y(cell), 0,
+				cellWidth, cellHeight, 1);
+		}
+		this->createVertexArray();
+	}
+
+	// Font from an RGBA image of its sheet, e.g. BuiltinFont::pixels()
+	TextRenderer(FrameRing &ring, const BitmapFont &font, const std::vector<std::uint8_t> &pixels)
+		: ring_(ring), font_(font)
+	{
+		// Pixel fonts stay sharp
+		this->createTexture(this->font_.sheet(), pixels.data(), GL_NEAREST);
+		this->createVertexArray();
+	}
+
+	TextRenderer(const TextRenderer &) = delete;
+	TextRenderer(TextRenderer &&) = delete;
+	TextRenderer &operator=(const TextRenderer &) = delete;
+	TextRenderer &operator=(TextRenderer &&) = delete;
+
+	~TextRenderer() {
+		glDeleteBuffers(1, &this->VBO_);
+		glDeleteVertexArrays(1, &this->VAO_);
+		glDeleteTextures(1, &this->texture_);
+	}
+
+	BitmapFont &font() noexcept { return this->font_; }
+
+	void setColor(const glm::vec4 &color) noexcept { this->color_ = color; }
+
+	// Add text for this frame, its bottom at at.y and its align edge at at.x
+	void text(const std::string &s, const glm::vec2 at, GLfloat scale = 1.0f, BitmapFont::Align align = BitmapFont::Left) {
+		this->font_.layout(s, at.x, at.y, scale, align, this->glyphs_);
+	}
+
+	void draw(Shader &shader) override {
+		if (this->write() == 0)
+			return;
+
+		shader.use();
+
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "projection"),
+			1, GL_FALSE, glm::value_ptr(PROJECTION));
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, this->texture_);
+		glUniform1i(glGetUniformLocation(shader.getProgram(), "fontTex"), 0);
+
+		RenderCommand command;
+		this->issue(shader, command);
+		glBindVertexArray(0);
+	}
+
+	// Glyphs are cut out by alpha test, so text is opaque
+	void submit(RenderQueue &queue, Shader &shader, float z) override {
+		if (this->write() == 0)
+			return;
+		RenderCommand command;
+		command.shader = &shader;
+		command.program = shader.getProgram();
+		command.target = GL_TEXTURE_2D;
+		command.texture = this->texture_;
+		command.z = z;
+		command.source = this;
+		queue.push(command);
+	}
+
+	void issue(Shader &shader, const RenderCommand &command) override {
+		glUniform1f(glGetUniformLocation(shader.getProgram(), "z"), command.z);
+		glUniform4fv(glGetUniformLocation(shader.getProgram(), "textColor"), 1, glm::value_ptr(this->color_));
+
+		glBindVertexArray(this->VAO_);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 6, this->count_);
+	}
+
+private:
+	// Vertex buffer binding of the glyph instances; the quad is binding 0
+	static constexpr GLuint INSTANCES = 1;
+	static constexpr GLuint INSTANCE_FLOATS = sizeof(GlyphQuad) / sizeof(GLfloat);
+
+	static void size(GLuint texture, GLint &width, GLint &height) {
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	// One row of cells the size of the first texture
+	static SpriteSheet row(TextureCache &textures, const std::vector<const char*> &cells) {
+		GLint width = 0, height = 0;
+		if (!cells.empty())
+			TextRenderer::size(textures.get(cells[0]), width, height);
+		return SpriteSheet(static_cast<int>(cells.size()), 1, width, height);
+	}
+
+	// pixels null: transparent, gutters included
+	void createTexture(const SpriteSheet &sheet, const std::uint8_t *pixels, GLint filter) {
+		std::vector<std::uint8_t> clear;
+		if (!pixels) {
+			clear.assign(4 * sheet.width() * sheet.height(), 0);
+			pixels = clear.data();
+		}
+		glGenTextures(1, &this->texture_);
+		glBindTexture(GL_TEXTURE_2D, this->texture_);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, sheet.width(), sheet.height(),
+			0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		// No mipmaps, they would blend neighbouring glyphs
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void createVertexArray() {
+		// Unit quad, 0..1 in both directions
+		GLfloat quad[] = {
+			0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+			1.0f, 1.0f,  0.0f, 1.0f,  0.0f, 0.0f
+		};
+
+		glGenVertexArrays(1, &this->VAO_);
+		glBindVertexArray(this->VAO_);
+
+		glGenBuffers(1, &this->VBO_);
+		glBindBuffer(GL_ARRAY_BUFFER, this->VBO_);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), reinterpret_cast<GLvoid*>(0));
+		glEnableVertexAttribArray(0);
+
+		// Glyphs <vec4 rect, vec4 uv rect> come from binding INSTANCES,
+		// pointed at the ring each frame
+		glVertexAttribFormat(1, 4, GL_FLOAT, GL_FALSE, 0);
+		glVertexAttribBinding(1, INSTANCES);
+		glEnableVertexAttribArray(1);
+		glVertexAttribFormat(2, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat));
+		glVertexAttribBinding(2, INSTANCES);
+		glEnableVertexAttribArray(2);
+		glVertexBindingDivisor(INSTANCES, 1);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	// Writes the glyphs of this frame into the ring and points the instance
+	// binding at them; returns how many there are
+	GLsizei write() {
+		this->count_ = 0;
+		if (this->glyphs_.empty())
+			return 0;
+		FrameAllocation a = this->ring_.allocate<GLfloat>(INSTANCE_FLOATS * this->glyphs_.size());
+		if (a) {
+			std::memcpy(a.data, this->glyphs_.data(), this->glyphs_.size() * sizeof(GlyphQuad));
+			this->ring_.commit(a);
+			this->count_ = static_cast<GLsizei>(this->glyphs_.size());
+
+			glBindVertexArray(this->VAO_);
+			glBindVertexBuffer(INSTANCES, a.buffer, a.offset, INSTANCE_FLOATS * sizeof(GLfloat));
+			glBindVertexArray(0);
+		}
+		this->glyphs_.clear();
+		return this->count_;
+	}
+
+	FrameRing &ring_;
+	BitmapFont font_;
+	glm::vec4 color_{ 1.0f, 1.0f, 1.0f, 1.0f };
+	std::vector<GlyphQuad> glyphs_;     // laid out since the last submit
+	GLsizei count_ = 0;                 // glyphs written by the last write()
+	GLuint texture_;
+	GLuint VAO_;
+	GLuint VBO_;
+};
+
+constexpr GLuint TextRenderer::INSTANCES;
+constexpr GLuint TextRenderer::INSTANCE_FLOATS;
+
+static_assert(sizeof(GlyphQuad) == 8 * sizeof(GLfloat), "a glyph instance is 8 floats");
+
+#endif // !TEXTRENDERER_H
@@ -0,0 +1,123 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <iostream>
+#include "GL\glew.h"
+#include "GL\SOIL.h"
+
+
+// Decoded RGBA8 pixels, produced on any thread
+struct Image {
+	int width = 0;
+	int height = 0;
+	std::vector<unsigned char> pixels;
+
+	bool empty() const noexcept { return this->pixels.empty(); }
+
+	// Decode an image file; empty on failure. Touches no GL state.
+	static Image decode(const char *path) {
+		Image result;
+		unsigned char* image = SOIL_load_image(path, &result.width, &result.height, 0, SOIL_LOAD_RGBA);
+		if (image) {
+			result.pixels.assign(image, image + 4 * result.width * result.height);
+			SOIL_free_image_data(image);
+		}
+		else {
+			std::cerr << "ERROR: in " << __FILE__
+				<< " line " << __LINE__
+				<< ": failed to load " << path << std::endl;
+		}
+		return result;
+	}
+};
+
+
+/*
+\  Process-wide texture cache: every image file is decoded and uploaded once,
+\  and all boards, tubes and particles of every game world share the GL texture.
+*/
+class TextureCache {
+public:
+	TextureCache() = default;
+
+	TextureCache(const TextureCache &) = delete;
+	TextureCache(TextureCache &&) = delete;
+	TextureCache &operator=(const TextureCache &) = delete;
+	TextureCache &operator=(TextureCache &&) = delete;
+
+	~TextureCache() {
+		for (auto &t : this->textures_)
+			glDeleteTextures(1, &t.second);
+	}
+
+	// Texture of the file, loaded on first use
+	GLuint get(const std::string &path) {
+		auto it = this->textures_.find(path);
+		if (it != this->textures_.end())
+			return it->second;
+
+		return this->put(path, Image::decode(path.c_str()));
+	}
+
+	// Upload an image decoded elsewhere (see AssetLoader); a cached path is kept
+	GLuint put(const std::string &path, const Image &image) {
+		auto it = this->textures_.find(path);
+		if (it != this->textures_.end())
+			return it->second;
+
+		GLuint texture = upload(image);
+		this->textures_.emplace(path, texture);
+		return texture;
+	}
+
+	// Upload a ready mip chain (see AssetPack): levels are RGBA8, level 0 first,
+	// each half the size of the one before and at least 1
+	GLuint put(const std::string &path, int width, int height, int levels, const unsigned char *pixels) {
+		auto it = this->textures_.find(path);
+		if (it != this->textures_.end())
+			return it->second;
+
+		GLuint texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		for (int i = 0; i < levels; ++i) {
+			int w = width >> i > 0 ? width >> i : 1, h = height >> i > 0 ? height >> i : 1;
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			pixels += 4 * w * h;
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		this->textures_.emplace(path, texture);
+		return texture;
+	}
+
+	bool contains(const std::string &path) const {
+		return this->textures_.count(path) != 0;
+	}
+
+	std::size_t size() const noexcept { return this->textures_.size(); }
+
+	// Upload with mipmaps; an empty image gives an empty texture
+	static GLuint upload(const Image &image) {
+		GLuint texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+
+		if (!image.empty()) {
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
+			glGenerateMipmap(GL_TEXTURE_2D);
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+
+private:
+	std::unordered_map<std::string, GLuint> textures_;
+};
+
+#endif // !TEXTURECACHE_H
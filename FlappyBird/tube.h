@@ -10,8 +10,9 @@
 #include "glm\gtc\type_ptr.hpp"
 #include "drawAble.h"
 #include "shader.h"
-#include "collisionWorld.h"
 #include "config.h"
+#include "textureCache.h"
+#include "gameRules.h"
 
 
 namespace TubeSp
@@ -19,8 +20,8 @@ namespace TubeSp
 	auto deletor = [](GLfloat *p) {delete[] p; };
 	using ArrayDelete = decltype(deletor);
 	constexpr std::size_t SIZE = /*3*/5 * 6 * 2;
-	constexpr GLfloat WIDTH = 50.0f; //0.1f;
-	constexpr GLfloat HEIGHT = 800.0f;//2.0f;
+	constexpr GLfloat WIDTH = GameRules::TUBE_HALFWIDTH; //0.1f;
+	constexpr GLfloat HEIGHT = GameRules::TUBE_HEIGHT;//2.0f;
 
 	inline auto getVertices(const GLfloat halfSpace)
 	{
@@ -47,40 +48,18 @@ namespace TubeSp
 
 
 // ڱʾ͹ܵ
+// Only draws the tube: GameSim moves it and tests it for collisions
 class Tube : public DrawAble {
 public:
-	using BoxT = utility::Collidable::BoxType;
-
-	Tube(const glm::vec3 pos = { 0.0f, 0.0f, 0.0f }, const GLfloat halfSpace = /*110.0f*/130.0f, const GLfloat height = 0.0f)
-		: position_(pos), vertices_(TubeSp::getVertices(halfSpace)),
-		upBox_(BoxT::RETENCGEL,
-			glm::vec3(pos.x, pos.y + halfSpace + 0.5f * TubeSp::HEIGHT, pos.z), 2.0f * TubeSp::WIDTH,  TubeSp::HEIGHT), // UpBox
-		downBox_(BoxT::RETENCGEL,
-			glm::vec3(pos.x, pos.y - halfSpace - 0.5f * TubeSp::HEIGHT, pos.z), 2.0f * TubeSp::WIDTH, TubeSp::HEIGHT)  // DownBox
+	Tube(TextureCache &textures,
+		const glm::vec3 pos = { 0.0f, 0.0f, 0.0f }, const GLfloat halfSpace = /*110.0f*/130.0f)
+		: position_(pos), halfSpace_(halfSpace), vertices_(TubeSp::getVertices(halfSpace)), texture_(textures.get("texture//tube.png"))
 	{
-		
-		if (!this->textureLoaded_) {
-			glGenTextures(1, &this->texture_);
-			glBindTexture(GL_TEXTURE_2D, this->texture_);
-
-			int textureWidth, textureHeight;
-			unsigned char* image = SOIL_load_image("texture//tube.png", &textureWidth, &textureHeight, 0, SOIL_LOAD_RGBA);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-			glGenerateMipmap(GL_TEXTURE_2D);
-
-			SOIL_free_image_data(image);
-			glBindTexture(GL_TEXTURE_2D, 0);
-
-			this->textureLoaded_ = true;
-		}
-
-
 		glGenVertexArrays(1, &this->VAO_);
 		glBindVertexArray(this->VAO_);
 
-		GLuint VBO;
-		glGenBuffers(1, &VBO);
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glGenBuffers(1, &this->VBO_);
+		glBindBuffer(GL_ARRAY_BUFFER, this->VBO_);
 
 		auto rp = vertices_.get();
 		GLfloat(&vArray)[TubeSp::SIZE] = *reinterpret_cast<GLfloat(*)[TubeSp::SIZE]>(rp);
@@ -94,14 +73,20 @@ public:
 		glBindVertexArray(0);
 	}
 
+	Tube(const Tube &) = delete;
+	Tube(Tube &&) = delete;
+	Tube &operator=(const Tube &) = delete;
+	Tube &operator=(Tube &&) = delete;
+
+	// Views are made once and reused, but still give their buffers back
+	~Tube() {
+		glDeleteBuffers(1, &this->VBO_);
+		glDeleteVertexArrays(1, &this->VAO_);
+	}
+
 	void draw(Shader &shader) override {
 		shader.use();
 
-		glm::mat4 model;
-		model = glm::translate(model, this->position_);
-		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "model"),
-			1, GL_FALSE, glm::value_ptr(model));
-
 		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "projection"),
 			1, GL_FALSE, glm::value_ptr(PROJECTION));
 
@@ -109,37 +94,60 @@ public:
 		glBindTexture(GL_TEXTURE_2D, texture_);
 		glUniform1i(glGetUniformLocation(shader.getProgram(), "wallTex"), 0);
 
+		RenderCommand command;
+		command.z = this->position_.z;
+		this->issue(shader, command);
+		glBindVertexArray(0);
+	}
+
+	void submit(RenderQueue &queue, Shader &shader, float z) override {
+		RenderCommand command;
+		command.shader = &shader;
+		command.program = shader.getProgram();
+		command.target = GL_TEXTURE_2D;
+		command.texture = this->texture_;
+		command.z = this->position_.z + z;
+		command.source = this;
+		queue.push(command);
+	}
+
+	void issue(Shader &shader, const RenderCommand &command) override {
+		glm::mat4 model;
+		model = glm::translate(model, glm::vec3(this->position_.x, this->position_.y, command.z));
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgram(), "model"),
+			1, GL_FALSE, glm::value_ptr(model));
+
 		glBindVertexArray(this->VAO_);
 		glDrawArrays(GL_TRIANGLES, 0, TubeSp::SIZE / 3);
-		glBindVertexArray(0);
 	}
 
-	void shift(const GLfloat deltaTime) {
-		this->position_.x += this->speed_ * deltaTime;
-		this->upBox_.position().x += this->speed_ * deltaTime;
-		this->downBox_.position().x += this->speed_ * deltaTime;
+	// ǷĻΧ(ĻĹӲύ)
+	bool visible() const noexcept {
+		return this->position_.x + TubeSp::WIDTH > -500.0f && this->position_.x - TubeSp::WIDTH < 500.0f;
 	}
 
-	auto getUpBox() const noexcept { return this->upBox_; }
-	auto getDownBox() const noexcept { return this->downBox_; }
+	// Move the gap centre to x, y on the screen; a new gap size refills the vertex buffer
+	void show(const GLfloat x, const GLfloat y, const GLfloat halfSpace) {
+		this->position_.x = x;
+		this->position_.y = y;
+		if (halfSpace != this->halfSpace_) {
+			this->halfSpace_ = halfSpace;
+			auto vertices = TubeSp::getVertices(halfSpace);
+			glBindBuffer(GL_ARRAY_BUFFER, this->VBO_);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, TubeSp::SIZE * sizeof(GLfloat), vertices.get());
+		}
+	}
 
 	const glm::vec3 &position() noexcept { return this->position_; }
 
 private:
 	const std::unique_ptr <GLfloat, TubeSp::ArrayDelete> vertices_;
 	GLuint VAO_;
-	const static GLfloat speed_;
-	static GLuint texture_;
-	static bool textureLoaded_;
+	GLuint VBO_;
 	glm::vec3 position_;
-	utility::Collidable upBox_;
-	utility::Collidable downBox_;
+	GLfloat halfSpace_;
+	GLuint texture_;
 };
 
 
-const GLfloat Tube::speed_ = -2500.0f;//-2500.0f;//-2.5f;
-GLuint Tube::texture_;
-bool Tube::textureLoaded_ = false;
-
-
 #endif // !TUBE_H
@@ -0,0 +1,346 @@
+#ifndef UI_H
+#define UI_H
+
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "GL\glew.h"
+#include "glm\glm.hpp"
+#include "shader.h"
+#include "board.h"
+#include "parallax.h"
+#include "button.h"
+#include "textRenderer.h"
+#include "assetLoader.h"
+#include "gameContext.h"
+#include "gameView.h"
+#include "scene.h"
+#include "uiLayout.h"
+#include "renderScaler.h"
+#include "renderQueue.h"
+#include "renderer.h"
+#include "config.h"
+
+
+struct Ui;
+
+
+// A screen of buttons and boards: main menu, mode and skin selection, game over
+class MenuScene : public Scene {
+public:
+	// ghostKey: 'g' toggles the ghost race on this screen
+	MenuScene(Ui &ui, GameContext &game, bool ghostKey) : ui_(ui), game_(game), ghostKey_(ghostKey) {}
+
+	MenuScene(const MenuScene &) = delete;
+	MenuScene(MenuScene &&) = delete;
+	MenuScene& operator=(const MenuScene &) = delete;
+	MenuScene& operator=(MenuScene &&) = delete;
+
+	// onClick runs when the button is released; id is the ButtonClick event value
+	void add(std::unique_ptr<Button> button, int id, std::function<void()> onClick) {
+		this->layout_.add(button->bounds(), static_cast<int>(this->buttons_.size()));
+		this->buttons_.push_back({ std::move(button), id, std::move(onClick) });
+	}
+
+	void add(std::unique_ptr<Board> board) {
+		this->boards_.push_back(std::move(board));
+	}
+
+	void draw() override;
+	void keyDown(unsigned char key) override;
+	void mouseDown(int x, int y) override;
+	void mouseUp(int x, int y) override;
+
+private:
+	struct Item {
+		std::unique_ptr<Button> button;
+		int id;
+		std::function<void()> onClick;
+	};
+
+	Ui &ui_;
+	GameContext &game_;
+	bool ghostKey_;
+	std::vector<Item> buttons_;
+	UiLayout layout_;      // index into buttons_ by position
+	std::vector<std::unique_ptr<Board>> boards_;
+	Item *pressed_ = nullptr;
+};
+
+
+// The running game
+class PlayingScene : public Scene {
+public:
+	PlayingScene(Ui &ui, GameContext &game) : ui_(ui), game_(game) {}
+
+	void update(float deltaTime) override;
+	void draw() override;
+	void keyDown(unsigned char key) override;
+	bool animated() const noexcept override { return true; }
+
+private:
+	Ui &ui_;
+	GameContext &game_;
+};
+
+
+// Over the frozen game until 'p' is pressed again
+class PausedScene : public Scene {
+public:
+	PausedScene(Ui &ui, GameContext &game) : ui_(ui), game_(game) {}
+
+	void keyDown(unsigned char key) override;
+	bool overlay() const noexcept override { return true; }
+
+private:
+	Ui &ui_;
+	GameContext &game_;
+};
+
+
+// 菜单界面与着色器
+struct Ui {
+	// Value of ButtonClick events
+	enum ButtonId { StartButton, OKButton, ModeButton, SkinButton, BackButton, EasyButton, NormalButton, HardButton, OriginButton, BlueButton };
+
+	Ui(SharedResources &shared, GameContext &game);
+
+	Ui(const Ui &) = delete;
+	Ui &operator=(const Ui &) = delete;
+
+	// 菜单用到的贴图
+	static std::vector<const char*> texturePaths() {
+		return { "texture//startButton.png", "texture//OKButton.png", "texture//backButton.png",
+			"texture//modeButton.png", "texture//easyButton.png", "texture//normalButton.png",
+			"texture//hardButton.png", "texture//skinButton.png", "texture//originButton.png",
+			"texture//blueButton.png", "texture//background.png", "texture//title.png", "texture//gameOver.png" };
+	}
+
+	// 着色器源文件
+	static std::vector<const char*> shaderPaths() {
+		return { "board.vert", "board.frag", "tube.vert", "tube.frag", "particle.vert", "particle.frag", "flock.vert", "flock.frag", "parallax.vert", "parallax.frag", "text.vert", "text.frag" };
+	}
+
+	// 交给AssetLoader预先解码
+	static void loadTextures(AssetLoader &loader) {
+		for (auto tex : texturePaths())
+			loader.texture(tex);
+	}
+
+	// Shaders are built one per loader step, so the loading screen keeps drawing.
+	// Button and board use the same sources, so they share one program.
+	void loadShaders(AssetLoader &loader) {
+		loader.task([this, &loader] { this->pButtonShader = &loader.shader("board.vert", "board.frag"); });
+		loader.task([this, &loader] { this->pTubeShader = &loader.shader("tube.vert", "tube.frag"); });
+		loader.task([this, &loader] { this->pBoardShader = &loader.shader("board.vert", "board.frag"); });
+		loader.task([this, &loader] { this->pParticleShader = &loader.shader("particle.vert", "particle.frag"); });
+		loader.task([this, &loader] { this->pFlockShader = &loader.shader("flock.vert", "flock.frag"); });
+		loader.task([this, &loader] { this->pParallaxShader = &loader.shader("parallax.vert", "parallax.frag"); });
+		loader.task([this, &loader] { this->pTextShader = &loader.shader("text.vert", "text.frag"); });
+	}
+
+	// Window size changed; v is the letterboxed part the game is drawn in
+	void resize(int height, const Viewport &v) {
+		this->viewport = { v.x, v.y, v.width, v.height };
+		this->windowHeight = height;
+	}
+
+	// Debug overlay: FPS, frame time, tick and particles, one draw call
+	void submitHud(const GameContext &game);
+
+	std::unique_ptr<ParallaxBackground> pBackground;
+	std::unique_ptr<TextRenderer> pHud;
+	std::unique_ptr<GameView> pView;    // of the one game world
+	Shader *pButtonShader = nullptr;
+	Shader *pTubeShader = nullptr;
+	Shader *pBoardShader = nullptr;
+	Shader *pParticleShader = nullptr;
+	Shader *pFlockShader = nullptr;
+	Shader *pParallaxShader = nullptr;
+	Shader *pTextShader = nullptr;
+
+	// Scenes submit their draws here; display() sorts and draws them once per frame
+	RenderQueue queue;
+	Renderer renderer;
+
+	// 各个界面, 只有栈顶的界面处理输入和更新
+	MenuScene menu;
+	MenuScene modeSelect;
+	MenuScene skinSelect;
+	MenuScene gameOver;
+	PlayingScene playing;
+	PausedScene paused;
+	SceneStack scenes;
+
+	// Mouse positions are mapped through these, see windowToWorld()
+	glm::ivec4 viewport{ 0, 0, SCREENWIDTH, SCREENHEIGTH };
+	int windowHeight = SCREENHEIGTH;
+
+	double nowMs = 0.0;        // InputQueue::nowMs() at the start of the frame
+	GLfloat deltaTime = 0.0;
+	GLfloat lastFrame = 0.0;
+	bool animating = false;    // the last frame kept the loop running
+#ifdef _DEBUG
+	bool showHud = true;       // 'h' toggles it
+#else
+	bool showHud = false;
+#endif
+	GLfloat hudFrameMs = 0.0f; // smoothed frame time shown by the HUD
+};
+
+
+inline Ui::Ui(SharedResources &shared, GameContext &game)
+	: pBackground(std::make_unique<ParallaxBackground>(shared.textures, "texture//background.png", std::vector<ParallaxLayer>{
+		{ 0.00f, 0.61f, 0.05f },     // 天空
+		{ 0.61f, 0.66f, 0.15f },     // 云
+		{ 0.66f, 0.72f, 0.3f },      // 城市
+		{ 0.72f, 1.00f, 0.6f } })),  // 草地
+	pHud(std::make_unique<TextRenderer>(shared.frames, BuiltinFont::font(3.0f), BuiltinFont::pixels())),
+	pView(std::make_unique<GameView>(shared, game)),
+	menu(*this, game, true), modeSelect(*this, game, true), skinSelect(*this, game, true), gameOver(*this, game, false),
+	playing(*this, game), paused(*this, game) {
+	TextureCache &textures = shared.textures;
+	const glm::vec3 small{ 1.41f, 0.5f, 1.0f };
+	auto title = [&textures] { return std::make_unique<Board>(textures, "texture//title.png", glm::vec3{ 0.0f, 200.0f, 0.0f }, glm::vec3{ 2.2f, 2.0f, 1.0f }); };
+	auto back = [&textures, &small] { return std::make_unique<Button>(textures, "texture//backButton.png", glm::vec3{ 0.0f, -360.0f, 0.0f }, small); };
+
+	// 开始界面
+	this->menu.add(std::make_unique<Button>(textures, "texture//startButton.png"), StartButton, [this, &game] {
+		// A new course every game; reset() alone replays courseSeed
+		game.courseSeed = std::random_device()();
+		game.reset();
+		this->pView->reset();
+		this->scenes.push(this->playing);
+	});
+	this->menu.add(std::make_unique<Button>(textures, "texture//modeButton.png", glm::vec3{ -150.0f, -170.0f, 0.0f }, small), ModeButton,
+		[this] { this->scenes.push(this->modeSelect); });
+	this->menu.add(std::make_unique<Button>(textures, "texture//skinButton.png", glm::vec3{ 150.0f, -170.0f, 0.0f }, small), SkinButton,
+		[this] { this->scenes.push(this->skinSelect); });
+	this->menu.add(title());
+
+	// 选择难度
+	this->modeSelect.add(back(), BackButton, [this] { this->scenes.pop(); });
+	this->modeSelect.add(std::make_unique<Button>(textures, "texture//easyButton.png", glm::vec3{ 0.0f, -120.0f, 0.0f }, small), EasyButton,
+		[&game] { game.mode = Easy; });
+	this->modeSelect.add(std::make_unique<Button>(textures, "texture//normalButton.png", glm::vec3{ 0.0f, -200.0f, 0.0f }, small), NormalButton,
+		[&game] { game.mode = Normal; });
+	this->modeSelect.add(std::make_unique<Button>(textures, "texture//hardButton.png", glm::vec3{ 0.0f, -280.0f, 0.0f }, small), HardButton,
+		[&game] { game.mode = Hard; });
+	this->modeSelect.add(title());
+
+	// 选择皮肤
+	this->skinSelect.add(back(), BackButton, [this] { this->scenes.pop(); });
+	this->skinSelect.add(std::make_unique<Button>(textures, "texture//originButton.png", glm::vec3{ 0.0f, -120.0f, 0.0f }, small), OriginButton,
+		[&game] { game.skin = Origin; });
+	this->skinSelect.add(std::make_unique<Button>(textures, "texture//blueButton.png", glm::vec3{ 0.0f, -240.0f, 0.0f }, small), BlueButton,
+		[&game] { game.skin = Blue; });
+	this->skinSelect.add(title());
+
+	// 游戏结束, 回到开始界面
+	this->gameOver.add(std::make_unique<Button>(textures, "texture//OKButton.png", glm::vec3{ 0.0f, 0.0f, 0.0f }, small), OKButton,
+		[this] { this->scenes.pop(); });
+	this->gameOver.add(std::make_unique<Board>(textures, "texture//gameOver.png", glm::vec3{ 0.0f, 250.0f, 0.0f }, glm::vec3{ 4.0f, 4.0f, 1.0f }));
+
+	this->scenes.push(this->menu);
+}
+
+
+inline void Ui::submitHud(const GameContext &game) {
+	if (!this->showHud)
+		return;
+
+	// deltaTime is 0.0001 * ms, see display()
+	GLfloat frameMs = this->deltaTime * 10000.0f;
+	this->hudFrameMs += (frameMs - this->hudFrameMs) * 0.1f;
+
+	char text[128];
+	std::snprintf(text, sizeof(text), "FPS %.0f\n%.2f MS\nTICK %u\nPARTICLES %d",
+		this->hudFrameMs > 0.0f ? 1000.0f / this->hudFrameMs : 0.0f, this->hudFrameMs,
+		static_cast<unsigned>(game.sim.tick()), static_cast<int>(this->pView->particles->alive()));
+	// First line at the top left of the view
+	this->pHud->text(text, { -490.0f, 490.0f - this->pHud->font().height() }, 1.0f, BitmapFont::Left);
+	this->pHud->submit(this->queue, *this->pTextShader, RenderLayer::Ui);
+}
+
+
+inline void MenuScene::draw() {
+	for (Item &item : this->buttons_)
+		item.button->submit(this->ui_.queue, *this->ui_.pButtonShader, RenderLayer::Ui);
+
+	for (auto &board : this->boards_)
+		board->submit(this->ui_.queue, *this->ui_.pBoardShader, RenderLayer::Ui);
+}
+
+
+inline void MenuScene::keyDown(unsigned char key) {
+	// 切换幽灵鸟竞速模式
+	if (key == 'g' && this->ghostKey_)
+		this->game_.isGhostRace = !this->game_.isGhostRace;
+}
+
+
+inline void MenuScene::mouseDown(int x, int y) {
+	glm::vec2 world = windowToWorld(x, y, this->ui_.windowHeight, this->ui_.viewport, PROJECTION);
+	int hit = this->layout_.find(world);
+	if (hit < 0)
+		return;
+	Item &item = this->buttons_[hit];
+	item.button->down();
+	this->pressed_ = &item;
+	this->game_.events.push(EventType::ButtonClick, this->game_.sim.tick(), item.id);
+}
+
+
+inline void MenuScene::mouseUp(int, int) {
+	// Released anywhere, like before: the press already chose the button
+	if (!this->pressed_)
+		return;
+	Item &item = *this->pressed_;
+	this->pressed_ = nullptr;
+	item.button->up();
+	item.onClick();
+}
+
+
+inline void PlayingScene::update(float) {
+	this->game_.update(this->ui_.nowMs);
+	this->ui_.pView->update(this->ui_.nowMs);
+	if (this->game_.sim.over())
+		this->ui_.scenes.replace(this->ui_.gameOver);
+}
+
+
+inline void PlayingScene::draw() {
+	this->ui_.pView->submit(this->ui_.queue, *this->ui_.pBoardShader, *this->ui_.pFlockShader, *this->ui_.pParticleShader, *this->ui_.pTubeShader, *this->ui_.pTextShader);
+}
+
+
+inline void PlayingScene::keyDown(unsigned char key) {
+	if (key == 'a') {
+		GameView &view = *this->ui_.pView;
+		for (std::size_t i = view.firstTube; i < view.firstTube + view.tubeCount; ++i) {
+			std::cout << "(" <<
+				view.tube(i).position().x <<
+				", " << view.tube(i).position().y << ")\n";
+		}
+	}
+
+	// 暂停
+	if (key == 'p') {
+		this->game_.pause();
+		this->ui_.scenes.push(this->ui_.paused);
+	}
+}
+
+
+inline void PausedScene::keyDown(unsigned char key) {
+	if (key == 'p') {
+		this->game_.resume();
+		this->ui_.scenes.pop();
+	}
+}
+
+#endif // !UI_H
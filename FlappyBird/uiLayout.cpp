@@ -0,0 +1,90 @@
+#include <algorithm>
+#include "uiLayout.h"
+
+
+constexpr std::size_t UiLayout::LEAF_SIZE;
+
+
+glm::vec2 windowToWorld(int x, int y, int windowHeight, const glm::ivec4 &viewport, const glm::mat4 &projection) {
+	// Pixel centre, flipped to GL's bottom-left origin, then to normalized device coordinates
+	float winX = x + 0.5f;
+	float winY = windowHeight - y - 0.5f;
+	glm::vec4 ndc{ (winX - viewport.x) / viewport.z * 2.0f - 1.0f, (winY - viewport.y) / viewport.w * 2.0f - 1.0f, 0.0f, 1.0f };
+	glm::vec4 world = glm::inverse(projection) * ndc;
+	return glm::vec2(world) / world.w;
+}
+
+
+void UiLayout::add(const UiRect &rect, int id) {
+	this->widgets_.push_back({ rect, id, this->widgets_.size() });
+	this->build();
+}
+
+
+void UiLayout::clear() {
+	this->widgets_.clear();
+	this->nodes_.clear();
+}
+
+
+void UiLayout::build() {
+	this->nodes_.clear();
+	if (!this->widgets_.empty())
+		this->buildNode(0, this->widgets_.size());
+}
+
+
+int UiLayout::buildNode(std::size_t first, std::size_t last) {
+	UiRect bounds = this->widgets_[first].rect;
+	for (std::size_t i = first + 1; i < last; ++i) {
+		const UiRect &r = this->widgets_[i].rect;
+		bounds = { std::min(bounds.minX, r.minX), std::min(bounds.minY, r.minY), std::max(bounds.maxX, r.maxX), std::max(bounds.maxY, r.maxY) };
+	}
+
+	int index = static_cast<int>(this->nodes_.size());
+	this->nodes_.push_back({ bounds, first, last - first, -1, -1 });
+	if (last - first <= LEAF_SIZE)
+		return index;
+
+	// Median split by centre along the wider side
+	bool alongX = bounds.maxX - bounds.minX >= bounds.maxY - bounds.minY;
+	std::size_t middle = first + (last - first) / 2;
+	std::nth_element(this->widgets_.begin() + first, this->widgets_.begin() + middle, this->widgets_.begin() + last,
+		[alongX](const Widget &a, const Widget &b) {
+			return alongX ? a.rect.minX + a.rect.maxX < b.rect.minX + b.rect.maxX
+				: a.rect.minY + a.rect.maxY < b.rect.minY + b.rect.maxY;
+		});
+	int left = this->buildNode(first, middle);
+	int right = this->buildNode(middle, last);
+	this->nodes_[index].left = left;
+	this->nodes_[index].right = right;
+	return index;
+}
+
+
+int UiLayout::find(const glm::vec2 &point) const {
+	if (this->nodes_.empty())
+		return -1;
+
+	const Widget *best = nullptr;
+	int stack[64];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0) {
+		const Node &node = this->nodes_[stack[--top]];
+		if (!node.bounds.contains(point))
+			continue;
+		if (node.left < 0) {
+			for (std::size_t i = node.first; i < node.first + node.count; ++i) {
+				const Widget &w = this->widgets_[i];
+				if (w.rect.contains(point) && (!best || w.order < best->order))
+					best = &w;
+			}
+		}
+		else {
+			stack[top++] = node.left;
+			stack[top++] = node.right;
+		}
+	}
+	return best ? best->id : -1;
+}
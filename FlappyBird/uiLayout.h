@@ -0,0 +1,70 @@
+#ifndef UILAYOUT_H
+#define UILAYOUT_H
+
+#include <cstddef>
+#include <vector>
+#include "glm\glm.hpp"
+
+
+// Axis-aligned rectangle in world units (the space PROJECTION maps to the screen)
+struct UiRect {
+	float minX, minY, maxX, maxY;
+
+	static UiRect around(const glm::vec2 &centre, const glm::vec2 &halfExtent) noexcept {
+		return { centre.x - halfExtent.x, centre.y - halfExtent.y, centre.x + halfExtent.x, centre.y + halfExtent.y };
+	}
+
+	bool contains(const glm::vec2 &p) const noexcept {
+		return p.x > this->minX && p.x < this->maxX && p.y > this->minY && p.y < this->maxY;
+	}
+};
+
+
+// Window pixel (GLUT: origin top left) to world position, through the
+// viewport (x, y, width, height; origin bottom left) and projection.
+// Pure math, so input handling never reads anything back from GL.
+glm::vec2 windowToWorld(int x, int y, int windowHeight, const glm::ivec4 &viewport, const glm::mat4 &projection);
+
+
+/*
+\  Answers "which widget is under this point" for one screen. Widgets are
+\  kept in a bounding volume tree: every node's rectangle covers its
+\  children, and each split halves the widgets along the wider axis, so a
+\  query only descends into nodes containing the point, O(log n) for
+\  widgets that do not overlap. Where they do, the widget added first wins.
+\  The tree is rebuilt on every add(); screens add a few widgets once.
+*/
+class UiLayout {
+public:
+	// id is returned by find()
+	void add(const UiRect &rect, int id);
+	void clear();
+
+	// id of the widget containing point, -1 when there is none
+	int find(const glm::vec2 &point) const;
+
+	std::size_t size() const noexcept { return this->widgets_.size(); }
+
+private:
+	static constexpr std::size_t LEAF_SIZE = 2;
+
+	struct Widget {
+		UiRect rect;
+		int id;
+		std::size_t order;     // add() order, lower wins overlaps
+	};
+
+	struct Node {
+		UiRect bounds;
+		std::size_t first, count;     // widgets of a leaf
+		int left, right;              // children, -1 in a leaf
+	};
+
+	void build();
+	int buildNode(std::size_t first, std::size_t last);
+
+	std::vector<Widget> widgets_;
+	std::vector<Node> nodes_;
+};
+
+#endif // !UILAYOUT_H
@@ -0,0 +1,119 @@
+#include <fstream>
+#include <iostream>
+#include "wavFile.h"
+
+
+namespace {
+	std::uint32_t get16(const std::uint8_t *p) {
+		return p[0] | (p[1] << 8);
+	}
+
+	std::uint32_t get32(const std::uint8_t *p) {
+		return get16(p) | (get16(p + 2) << 16);
+	}
+
+	void put16(std::vector<std::uint8_t> &out, std::uint32_t v) {
+		out.push_back(static_cast<std::uint8_t>(v));
+		out.push_back(static_cast<std::uint8_t>(v >> 8));
+	}
+
+	void put32(std::vector<std::uint8_t> &out, std::uint32_t v) {
+		put16(out, v);
+		put16(out, v >> 16);
+	}
+
+	void putId(std::vector<std::uint8_t> &out, const char *id) {
+		out.insert(out.end(), id, id + 4);
+	}
+}
+
+
+bool readFile(const std::string &path, std::vector<std::uint8_t> &bytes) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		std::cerr << "ERROR: in " << __FILE__
+			<< " line " << __LINE__
+			<< ": failed to open " << path << std::endl;
+		return false;
+	}
+	std::streamsize size = file.tellg();
+	file.seekg(0);
+	bytes.resize(static_cast<std::size_t>(size));
+	return size == 0 || static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), size));
+}
+
+
+bool decodeWav(const std::uint8_t *data, std::size_t size, PcmData &pcm) {
+	if (size < 12 || std::string(reinterpret_cast<const char*>(data), 4) != "RIFF"
+		|| std::string(reinterpret_cast<const char*>(data + 8), 4) != "WAVE")
+		return false;
+
+	bool haveFormat = false;
+	std::size_t pos = 12;
+	while (pos + 8 <= size) {
+		std::string id(reinterpret_cast<const char*>(data + pos), 4);
+		std::size_t length = get32(data + pos + 4);
+		const std::uint8_t *body = data + pos + 8;
+		if (length > size - pos - 8)
+			length = size - pos - 8;    // some writers leave a wrong size on the last chunk
+
+		if (id == "fmt " && length >= 16) {
+			// format 1 = PCM
+			if (get16(body) != 1)
+				return false;
+			pcm.channels = static_cast<int>(get16(body + 2));
+			pcm.sampleRate = static_cast<int>(get32(body + 4));
+			pcm.bitsPerSample = static_cast<int>(get16(body + 14));
+			if (pcm.channels < 1 || pcm.channels > 2 || (pcm.bitsPerSample != 8 && pcm.bitsPerSample != 16))
+				return false;
+			haveFormat = true;
+		}
+		else if (id == "data") {
+			if (!haveFormat)
+				return false;
+			pcm.samples.assign(body, body + length);
+			return true;
+		}
+
+		// Chunks are padded to even sizes
+		pos += 8 + length + (length & 1);
+	}
+	return false;
+}
+
+
+void encodeWav(const PcmData &pcm, std::vector<std::uint8_t> &bytes) {
+	std::uint32_t blockAlign = static_cast<std::uint32_t>(pcm.channels * pcm.bitsPerSample / 8);
+	std::uint32_t size = static_cast<std::uint32_t>(pcm.samples.size());
+	bytes.clear();
+	bytes.reserve(44 + size + 1);
+	putId(bytes, "RIFF");
+	put32(bytes, 36 + size + (size & 1));
+	putId(bytes, "WAVE");
+	putId(bytes, "fmt ");
+	put32(bytes, 16);
+	put16(bytes, 1);
+	put16(bytes, static_cast<std::uint32_t>(pcm.channels));
+	put32(bytes, static_cast<std::uint32_t>(pcm.sampleRate));
+	put32(bytes, static_cast<std::uint32_t>(pcm.sampleRate) * blockAlign);
+	put16(bytes, blockAlign);
+	put16(bytes, static_cast<std::uint32_t>(pcm.bitsPerSample));
+	putId(bytes, "data");
+	put32(bytes, size);
+	bytes.insert(bytes.end(), pcm.samples.begin(), pcm.samples.end());
+	if (size & 1)
+		bytes.push_back(0);
+}
+
+
+bool writeFile(const std::string &path, const std::vector<std::uint8_t> &bytes) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		std::cerr << "ERROR: in " << __FILE__
+			<< " line " << __LINE__
+			<< ": failed to create " << path << std::endl;
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	return static_cast<bool>(file);
+}
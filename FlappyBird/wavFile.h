@@ -0,0 +1,37 @@
+#ifndef WAVFILE_H
+#define WAVFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Uncompressed PCM samples, interleaved, little endian
+struct PcmData {
+	int channels = 0;
+	int sampleRate = 0;
+	int bitsPerSample = 0;       // 8 or 16
+	std::vector<std::uint8_t> samples;
+
+	bool empty() const noexcept { return this->samples.empty(); }
+	std::size_t frames() const noexcept {
+		return this->channels && this->bitsPerSample ? this->samples.size() / (this->channels * this->bitsPerSample / 8) : 0;
+	}
+};
+
+
+// Whole file into bytes; false when it cannot be read
+bool readFile(const std::string &path, std::vector<std::uint8_t> &bytes);
+
+// Parse a RIFF/WAVE file holding 8 or 16 bit PCM. Touches no OpenAL state,
+// so it can run on any thread. False for other formats or broken files.
+bool decodeWav(const std::uint8_t *data, std::size_t size, PcmData &pcm);
+
+// The samples as a canonical 44 byte header RIFF/WAVE file
+void encodeWav(const PcmData &pcm, std::vector<std::uint8_t> &bytes);
+
+// Replace the file with bytes; false when it cannot be written
+bool writeFile(const std::string &path, const std::vector<std::uint8_t> &bytes);
+
+#endif // !WAVFILE_H